@@ -1,9 +1,11 @@
 #include"grid3d.h"
 #include<assert.h>
-#include "IndexRange.h"
+#include<cstdlib>
+#include<cstring>
+#include "cubic/IndexRange.h"
 
 template <typename FP>
-FP* grid3d(std::array<std::int64_t, 3> shape, std::array<FP, 3> size) {
+AlignedBuffer<FP> grid3d(std::array<std::int64_t, 3> shape, std::array<FP, 3> size) {
 	/* Reference implementation. */
 	using namespace std;
 	/* Initialization. */
@@ -16,7 +18,8 @@ FP* grid3d(std::array<std::int64_t, 3> shape, std::array<FP, 3> size) {
 		delta[i] = shn1 == 0 ? 0.0f : size[i] / shn1;
 		shift[i] = shn1 / FP(2);
 	}
-	FP* data = new FP[nelem * 3];
+	AlignedBuffer<FP> buffer(nelem * 3);
+	FP* data = buffer.data();
 
 
 	/* Fill arrays */
@@ -32,13 +35,14 @@ FP* grid3d(std::array<std::int64_t, 3> shape, std::array<FP, 3> size) {
 			}
 		}
 	}
-	return data;
+	return buffer;
 }
-template float* grid3d(std::array<std::int64_t, 3> shape, std::array<float, 3> size);
+template AlignedBuffer<float> grid3d(std::array<std::int64_t, 3> shape, std::array<float, 3> size);
+template AlignedBuffer<double> grid3d(std::array<std::int64_t, 3> shape, std::array<double, 3> size);
 
 
 template <typename FP>
-Vec3<FP>* grid3d_struct(std::array<std::int64_t, 3> shape, std::array<FP, 3> size) {
+AlignedBuffer<Vec3<FP>> grid3d_struct(std::array<std::int64_t, 3> shape, std::array<FP, 3> size) {
 	/* Struct, ~identical. */
 	using namespace std;
 	/* Initialization. */
@@ -51,7 +55,8 @@ Vec3<FP>* grid3d_struct(std::array<std::int64_t, 3> shape, std::array<FP, 3> siz
 		delta[i] = shn1 == 0 ? 0.0f : size[i] / shn1;
 		shift[i] = shn1 / FP(2);
 	}
-	Vec3<FP>* data = new Vec3<FP>[nelem];
+	AlignedBuffer<Vec3<FP>> buffer(nelem);
+	Vec3<FP>* data = buffer.data();
 
 
 	/* Fill arrays */
@@ -66,13 +71,14 @@ Vec3<FP>* grid3d_struct(std::array<std::int64_t, 3> shape, std::array<FP, 3> siz
 			}
 		}
 	}
-	return data;
+	return buffer;
 }
-template Vec3<float>* grid3d_struct(std::array<std::int64_t, 3> shape, std::array<float, 3> size);
+template AlignedBuffer<Vec3<float>> grid3d_struct(std::array<std::int64_t, 3> shape, std::array<float, 3> size);
+template AlignedBuffer<Vec3<double>> grid3d_struct(std::array<std::int64_t, 3> shape, std::array<double, 3> size);
 
 
 template <typename FP>
-FP* grid3d_memcpy(std::array<std::int64_t, 3> shape, std::array<FP, 3> size) {
+AlignedBuffer<FP> grid3d_memcpy(std::array<std::int64_t, 3> shape, std::array<FP, 3> size) {
 	/* Optimal single thread performance (reduced parallel gain). */
 	using namespace std;
 	/* Initialization. */
@@ -85,36 +91,39 @@ FP* grid3d_memcpy(std::array<std::int64_t, 3> shape, std::array<FP, 3> size) {
 		delta[i] = shn1 == 0 ? 0.0f : size[i] / shn1;
 		shift[i] = shn1 / FP(2);
 	}
-	FP* data = new FP[nelem * 3];
+	AlignedBuffer<FP> buffer(nelem * 3);
+	FP* data = buffer.data();
 
 	/* Fill first 2D slice */
 	FP* dptr = data;
-	FP zval = (0 - shift[2]) * delta[2];
+	FP xval = (0 - shift[0]) * delta[0];
 	for (int64_t y = 0; y < shape[1]; y++) {
-		for (int64_t x = 0; x < shape[2]; x++) {
-			*dptr++ = (x - shift[0]) * delta[0];
-			*dptr++ = (y - shift[1]) * delta[1];
-			*dptr++ = zval;
+		FP yval = (y - shift[1]) * delta[1];
+		for (int64_t z = 0; z < shape[2]; z++) {
+			*dptr++ = xval;
+			*dptr++ = yval;
+			*dptr++ = (z - shift[2]) * delta[2];
 		}
 	}
 
 	/* Fill remaining slices */
 	const int64_t nfp_2d = shape[1] * shape[2] * 3;
 	const int64_t cpy_size = nfp_2d * sizeof(FP);
-	for (int64_t z = 1; z < shape[2]; z++) {
-		FP* dptr = data + (z * nfp_2d);
+	for (int64_t x = 1; x < shape[0]; x++) {
+		FP* dptr = data + (x * nfp_2d);
 		memcpy(reinterpret_cast<void*>(dptr), reinterpret_cast<void*>(data), cpy_size);
-		FP zval = (z - shift[2]) * delta[2];
-		for (; dptr < data + (z * (nfp_2d + 1)); dptr += 3) {
-			*dptr = zval;
+		FP xval = (x - shift[0]) * delta[0];
+		for (; dptr < data + ((x + 1) * nfp_2d); dptr += 3) {
+			*dptr = xval;
 		}
 	}
-	return data;
+	return buffer;
 }
-template float* grid3d_memcpy(std::array<std::int64_t, 3> shape, std::array<float, 3> size);
+template AlignedBuffer<float> grid3d_memcpy(std::array<std::int64_t, 3> shape, std::array<float, 3> size);
+template AlignedBuffer<double> grid3d_memcpy(std::array<std::int64_t, 3> shape, std::array<double, 3> size);
 
 template <typename FP>
-FP* grid3d_p1(std::array<std::int64_t, 3> shape, std::array<FP, 3> size) {
+AlignedBuffer<FP> grid3d_p1(std::array<std::int64_t, 3> shape, std::array<FP, 3> size) {
 	using namespace std;
 	/* Initialization. */
 	int64_t nelem = 1;
@@ -126,7 +135,8 @@ FP* grid3d_p1(std::array<std::int64_t, 3> shape, std::array<FP, 3> size) {
 		delta[i] = shn1 == 0 ? 0.0f : size[i] / shn1;
 		shift[i] = shn1 / FP(2);
 	}
-	FP* data = new FP[nelem * 3];
+	AlignedBuffer<FP> buffer(nelem * 3);
+	FP* data = buffer.data();
 
 
 	/* Fill arrays */
@@ -143,12 +153,13 @@ FP* grid3d_p1(std::array<std::int64_t, 3> shape, std::array<FP, 3> size) {
 			}
 		}
 	}
-	return data;
+	return buffer;
 }
-template float* grid3d_p1(std::array<std::int64_t, 3> shape, std::array<float, 3> size);
+template AlignedBuffer<float> grid3d_p1(std::array<std::int64_t, 3> shape, std::array<float, 3> size);
+template AlignedBuffer<double> grid3d_p1(std::array<std::int64_t, 3> shape, std::array<double, 3> size);
 
 template <typename FP>
-FP* grid3d_p2(std::array<std::int64_t, 3> shape, std::array<FP, 3> size) {
+AlignedBuffer<FP> grid3d_p2(std::array<std::int64_t, 3> shape, std::array<FP, 3> size) {
 	/* Parallel second loop. */
 	using namespace std;
 	/* Initialization. */
@@ -161,14 +172,15 @@ FP* grid3d_p2(std::array<std::int64_t, 3> shape, std::array<FP, 3> size) {
 		delta[i] = shn1 == 0 ? 0.0f : size[i] / shn1;
 		shift[i] = shn1 / FP(2);
 	}
-	FP* data = new FP[nelem * 3];
+	AlignedBuffer<FP> buffer(nelem * 3);
+	FP* data = buffer.data();
 
 
 	/* Fill arrays */
 	for (int64_t x = 0; x < shape[0]; x++) {
 #pragma omp parallel for
 		for (int64_t y = 0; y < shape[1]; y++) {
-			FP* dptr = data + (x * shape[1] * shape[2] + y * shape[2]);
+			FP* dptr = data + (x * shape[1] * shape[2] + y * shape[2]) * 3;
 			for (int64_t z = 0; z < shape[2]; z++) {
 				*dptr++ = (x - shift[0]) * delta[0];
 				*dptr++ = (y - shift[1]) * delta[1];
@@ -176,13 +188,14 @@ FP* grid3d_p2(std::array<std::int64_t, 3> shape, std::array<FP, 3> size) {
 			}
 		}
 	}
-	return data;
+	return buffer;
 }
-template float* grid3d_p2(std::array<std::int64_t, 3> shape, std::array<float, 3> size);
+template AlignedBuffer<float> grid3d_p2(std::array<std::int64_t, 3> shape, std::array<float, 3> size);
+template AlignedBuffer<double> grid3d_p2(std::array<std::int64_t, 3> shape, std::array<double, 3> size);
 
 
 template <typename FP>
-Vec3<FP>* grid3d_struct_cpy(std::array<std::int64_t, 3> shape, std::array<FP, 3> size) {
+AlignedBuffer<Vec3<FP>> grid3d_struct_cpy(std::array<std::int64_t, 3> shape, std::array<FP, 3> size) {
 	/* Struct + memcpy, ~perf. as struct. */
 	using namespace std;
 	/* Initialization. */
@@ -195,7 +208,8 @@ Vec3<FP>* grid3d_struct_cpy(std::array<std::int64_t, 3> shape, std::array<FP, 3>
 		delta[i] = shn1 == 0 ? 0.0f : size[i] / shn1;
 		shift[i] = shn1 / FP(2);
 	}
-	Vec3<FP>* data = new Vec3<FP>[nelem];
+	AlignedBuffer<Vec3<FP>> buffer(nelem);
+	Vec3<FP>* data = buffer.data();
 
 
 	/* Fill arrays */
@@ -209,12 +223,13 @@ Vec3<FP>* grid3d_struct_cpy(std::array<std::int64_t, 3> shape, std::array<FP, 3>
 			}
 		}
 	}
-	return data;
+	return buffer;
 }
-template Vec3<float>* grid3d_struct_cpy(std::array<std::int64_t, 3> shape, std::array<float, 3> size);
+template AlignedBuffer<Vec3<float>> grid3d_struct_cpy(std::array<std::int64_t, 3> shape, std::array<float, 3> size);
+template AlignedBuffer<Vec3<double>> grid3d_struct_cpy(std::array<std::int64_t, 3> shape, std::array<double, 3> size);
 
 template <typename FP>
-FP* grid3d_ins(std::array<std::int64_t, 3> shape, std::array<FP, 3> size) {
+AlignedBuffer<FP> grid3d_ins(std::array<std::int64_t, 3> shape, std::array<FP, 3> size) {
 	/* Half perf of og. */
 	using namespace std;
 	/* Initialization. */
@@ -227,7 +242,8 @@ FP* grid3d_ins(std::array<std::int64_t, 3> shape, std::array<FP, 3> size) {
 		delta[i] = shn1 == 0 ? 0.0f : size[i] / shn1;
 		shift[i] = shn1 / FP(2);
 	}
-	FP* data = new FP[nelem * 3];
+	AlignedBuffer<FP> buffer(nelem * 3);
+	FP* data = buffer.data();
 
 
 	/* Fill arrays */
@@ -242,13 +258,14 @@ FP* grid3d_ins(std::array<std::int64_t, 3> shape, std::array<FP, 3> size) {
 			}
 		}
 	}
-	return data;
+	return buffer;
 }
-template float* grid3d_ins(std::array<std::int64_t, 3> shape, std::array<float, 3> size);
+template AlignedBuffer<float> grid3d_ins(std::array<std::int64_t, 3> shape, std::array<float, 3> size);
+template AlignedBuffer<double> grid3d_ins(std::array<std::int64_t, 3> shape, std::array<double, 3> size);
 
 
 template <typename FP>
-FP* grid3d_r(std::array<std::int64_t, 3> shape, std::array<FP, 3> size) {
+AlignedBuffer<FP> grid3d_r(std::array<std::int64_t, 3> shape, std::array<FP, 3> size) {
 	/* IndexRange(), no perf. difference. */
 	using namespace std;
 	/* Initialization. */
@@ -261,7 +278,8 @@ FP* grid3d_r(std::array<std::int64_t, 3> shape, std::array<FP, 3> size) {
 		delta[i] = shn1 == 0 ? FP(0) : size[i] / shn1;
 		shift[i] = shn1 / FP(2);
 	}
-	FP* data = new FP[nelem * 3];
+	AlignedBuffer<FP> buffer(nelem * 3);
+	FP* data = buffer.data();
 
 
 	/* Fill arrays */
@@ -275,13 +293,14 @@ FP* grid3d_r(std::array<std::int64_t, 3> shape, std::array<FP, 3> size) {
 			}
 		}
 	}
-	return data;
+	return buffer;
 }
-template float* grid3d_r(std::array<std::int64_t, 3> shape, std::array<float, 3> size);
+template AlignedBuffer<float> grid3d_r(std::array<std::int64_t, 3> shape, std::array<float, 3> size);
+template AlignedBuffer<double> grid3d_r(std::array<std::int64_t, 3> shape, std::array<double, 3> size);
 
 
 template <typename FP>
-FP* grid3d_b(std::array<std::int64_t, 3> shape, std::array<FP, 3> size) {
+AlignedBuffer<FP> grid3d_b(std::array<std::int64_t, 3> shape, std::array<FP, 3> size) {
 	/* Single loop, slow */
 	using namespace std;
 	/* Initialization. */
@@ -294,19 +313,21 @@ FP* grid3d_b(std::array<std::int64_t, 3> shape, std::array<FP, 3> size) {
 		delta[i] = shn1 == 0 ? 0.0f : size[i] / shn1;
 		shift[i] = shn1 / FP(2);
 	}
-	FP* data = new FP[nelem * 3];
+	AlignedBuffer<FP> buffer(nelem * 3);
+	FP* data = buffer.data();
 
-	std::array<int64_t, 3> sh_prod{ shape[0] * shape[1], shape[1], 1 };
+	std::array<int64_t, 3> sh_prod{ shape[1] * shape[2], shape[2], 1 };
 
 	/* Loop over elements */
 	FP* dptr = data;
 	for (int64_t i = 0; i < nelem; i++) {
-		std::lldiv_t dv = std::div(i, sh_prod[0]);
+		std::lldiv_t dv = std::lldiv(i, sh_prod[0]);
 		*dptr++ = (dv.quot - shift[0]) * delta[0];
-		dv = std::div(dv.rem, sh_prod[1]);
+		dv = std::lldiv(dv.rem, sh_prod[1]);
 		*dptr++ = (dv.quot - shift[1]) * delta[1];
 		*dptr++ = (dv.rem - shift[2]) * delta[2];
 	}
-	return data;
+	return buffer;
 }
-template float* grid3d_b(std::array<std::int64_t, 3> shape, std::array<float, 3> size);
\ No newline at end of file
+template AlignedBuffer<float> grid3d_b(std::array<std::int64_t, 3> shape, std::array<float, 3> size);
+template AlignedBuffer<double> grid3d_b(std::array<std::int64_t, 3> shape, std::array<double, 3> size);
\ No newline at end of file
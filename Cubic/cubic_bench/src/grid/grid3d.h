@@ -0,0 +1,40 @@
+#pragma once
+
+#include "cubic/aligned_buffer.h"
+
+#include<array>
+#include<cstdint>
+
+template <typename FP>
+struct Vec3 {
+	FP x, y, z;
+};
+
+template <typename FP = double>
+AlignedBuffer<FP> grid3d(std::array<std::int64_t, 3> shape, std::array<FP, 3> size);
+
+template <typename FP = double>
+AlignedBuffer<Vec3<FP>> grid3d_struct(std::array<std::int64_t, 3> shape, std::array<FP, 3> size);
+
+template <typename FP>
+AlignedBuffer<Vec3<FP>> grid3d_struct_cpy(std::array<std::int64_t, 3> shape, std::array<FP, 3> size);
+
+template <typename FP = double>
+AlignedBuffer<FP> grid3d_r(std::array<std::int64_t, 3> shape, std::array<FP, 3> size);
+
+template <typename FP = double>
+AlignedBuffer<FP> grid3d_b(std::array<std::int64_t, 3> shape, std::array<FP, 3> size);
+
+template <typename FP = double>
+AlignedBuffer<FP> grid3d_p1(std::array<std::int64_t, 3> shape, std::array<FP, 3> size);
+
+template <typename FP = double>
+AlignedBuffer<FP> grid3d_p2(std::array<std::int64_t, 3> shape, std::array<FP, 3> size);
+
+
+template <typename FP = double>
+AlignedBuffer<FP> grid3d_ins(std::array<std::int64_t, 3> shape, std::array<FP, 3> size);
+
+
+template <typename FP>
+AlignedBuffer<FP> grid3d_memcpy(std::array<std::int64_t, 3> shape, std::array<FP, 3> size);
\ No newline at end of file
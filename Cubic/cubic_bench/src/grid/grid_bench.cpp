@@ -0,0 +1,209 @@
+// grid_bench : Timing of the grid generation variants in 'grid3d.h' and the strategies of 'ndgrid()'.
+//
+// Usage: grid_bench [--N points] [--runs count] [--csv file]
+//
+// Every variant generates 3D grids of about N points for a set of shapes (cube, thin first / last dimension, a
+// short row and a single non-unit dimension), for float and double and thread counts 1, 2, 4, ... up to the OpenMP maximum.
+// 'ndgrid_planes' generates the same grid in structure-of-arrays layout.
+// The best time over the runs is reported in ns per point (including the allocation and first touch of the
+// buffer), output is compared with the reference 'grid3d()'.
+//
+
+#include "grid3d.h"
+#include "cubic/ndgrid.h"
+
+#include<algorithm>
+#include<chrono>
+#include<cmath>
+#include<cstdint>
+#include<cstdio>
+#include<cstdlib>
+#include<cstring>
+#include<functional>
+#include<memory>
+#include<string>
+#include<type_traits>
+#include<vector>
+
+#ifdef _OPENMP
+#include<omp.h>
+#endif
+
+
+typedef std::array<std::int64_t, 3> Shape;
+
+/* Generated grid, owner keeps the buffer (of FP or Vec3<FP>) alive. Planar grids store coordinate i of point j at
+data[i * plane_stride + j], others are interleaved (plane_stride = 0). */
+template<typename FP>
+struct Grid {
+	std::shared_ptr<void> owner;
+	const FP* data;
+	std::int64_t plane_stride = 0;
+};
+
+template<typename FP, typename T>
+static Grid<FP> make_grid(AlignedBuffer<T>&& buffer)
+{
+	auto owner = std::make_shared<AlignedBuffer<T>>(std::move(buffer));
+	return { owner, reinterpret_cast<const FP*>(owner->data()) };
+}
+
+template<typename FP>
+static Grid<FP> make_grid(NdgridPlanes<FP, 3>&& planes)
+{
+	auto owner = std::make_shared<NdgridPlanes<FP, 3>>(std::move(planes));
+	return { owner, owner->plane(0), owner->stride() };
+}
+
+/* Bitwise comparison with the interleaved reference. */
+template<typename FP>
+static bool grid_matches(const Grid<FP>& grid, const FP* ref, std::int64_t npoints)
+{
+	if (grid.plane_stride == 0) {
+		return std::memcmp(grid.data, ref, 3 * npoints * sizeof(FP)) == 0;
+	}
+	for (std::int64_t j = 0; j < npoints; j++) {
+		for (std::int64_t i = 0; i < 3; i++) {
+			if (std::memcmp(grid.data + i * grid.plane_stride + j, ref + 3 * j + i, sizeof(FP)) != 0) {
+				return false;
+			}
+		}
+	}
+	return true;
+}
+
+template<typename FP>
+struct GridVariant {
+	const char* name;
+	std::function<Grid<FP>(Shape, std::array<FP, 3>)> generate;
+};
+
+template<typename FP>
+static std::vector<GridVariant<FP>> grid_variants()
+{
+	typedef std::array<FP, 3> Size;
+	AllocConfig huge;
+	huge.huge_pages = true;
+	return {
+		{ "grid3d", [](Shape s, Size l) { return make_grid<FP>(grid3d<FP>(s, l)); } },
+		{ "grid3d_struct", [](Shape s, Size l) { return make_grid<FP>(grid3d_struct<FP>(s, l)); } },
+		{ "grid3d_struct_cpy", [](Shape s, Size l) { return make_grid<FP>(grid3d_struct_cpy<FP>(s, l)); } },
+		{ "grid3d_memcpy", [](Shape s, Size l) { return make_grid<FP>(grid3d_memcpy<FP>(s, l)); } },
+		{ "grid3d_p1", [](Shape s, Size l) { return make_grid<FP>(grid3d_p1<FP>(s, l)); } },
+		{ "grid3d_p2", [](Shape s, Size l) { return make_grid<FP>(grid3d_p2<FP>(s, l)); } },
+		{ "grid3d_ins", [](Shape s, Size l) { return make_grid<FP>(grid3d_ins<FP>(s, l)); } },
+		{ "grid3d_r", [](Shape s, Size l) { return make_grid<FP>(grid3d_r<FP>(s, l)); } },
+		{ "grid3d_b", [](Shape s, Size l) { return make_grid<FP>(grid3d_b<FP>(s, l)); } },
+		{ "ndgrid_rows", [](Shape s, Size l) { return make_grid<FP>(ndgrid<FP, 3>(s, l, NdgridStrategy::ROWS)); } },
+		{ "ndgrid_slice_copy", [](Shape s, Size l) { return make_grid<FP>(ndgrid<FP, 3>(s, l, NdgridStrategy::SLICE_COPY)); } },
+		{ "ndgrid_parallel_tiles", [](Shape s, Size l) { return make_grid<FP>(ndgrid<FP, 3>(s, l, NdgridStrategy::PARALLEL_TILES)); } },
+		{ "ndgrid", [](Shape s, Size l) { return make_grid<FP>(ndgrid<FP, 3>(s, l)); } },
+		{ "ndgrid_huge_pages", [huge](Shape s, Size l) { return make_grid<FP>(ndgrid<FP, 3>(s, l, NdgridStrategy::AUTO, huge)); } },
+		{ "ndgrid_planes", [](Shape s, Size l) { return make_grid<FP>(ndgrid_planes<FP, 3>(s, l)); } },
+	};
+}
+
+static std::string shape_str(const Shape& s)
+{
+	return std::to_string(s[0]) + "x" + std::to_string(s[1]) + "x" + std::to_string(s[2]);
+}
+
+template<typename FP>
+static void run(const std::vector<Shape>& shapes, const std::vector<int>& threads, int runs, FILE* csv)
+{
+	const char* dtype = std::is_same<float, FP>::value ? "float" : "double";
+	const std::array<FP, 3> size = { (FP)2.0, (FP)3.0, (FP)4.0 };
+	for (const Shape& shape : shapes) {
+		const std::int64_t npoints = shape[0] * shape[1] * shape[2];
+		const AlignedBuffer<FP> ref = grid3d<FP>(shape, size);
+
+		std::printf("%s | %s\n\n", dtype, shape_str(shape).c_str());
+		std::printf("Variant");
+		for (int t : threads) {
+			std::printf(" | %d thr. (ns)", t);
+		}
+		std::printf(" | Match\n---");
+		for (std::size_t t = 0; t <= threads.size(); t++) {
+			std::printf(" | ---");
+		}
+		std::printf("\n");
+
+		for (const GridVariant<FP>& variant : grid_variants<FP>()) {
+			std::printf("%s", variant.name);
+			bool match = true;
+			for (int t : threads) {
+#ifdef _OPENMP
+				omp_set_num_threads(t);
+#endif
+				double best = INFINITY;
+				for (int r = 0; r < runs; r++) {
+					auto start = std::chrono::high_resolution_clock::now();
+					const Grid<FP> grid = variant.generate(shape, size);
+					std::chrono::duration<double, std::nano> duration = std::chrono::high_resolution_clock::now() - start;
+					best = std::min(best, duration.count() / npoints);
+					match = match && grid_matches(grid, ref.data(), npoints);
+				}
+				std::printf(" | %.3f", best);
+				if (csv) {
+					std::fprintf(csv, "%s,%s,%s,%d,%.4f,%d\n", variant.name, dtype, shape_str(shape).c_str(), t, best, (int)match);
+				}
+			}
+			std::printf(" | %s\n", match ? "yes" : "NO");
+		}
+		std::printf("\n");
+	}
+}
+
+
+int main(int argc, char* argv[])
+{
+	std::int64_t N = 1 << 22;
+	int runs = 5;
+	const char* csv_path = nullptr;
+	for (int i = 1; i < argc; i += 2) {
+		if (i + 1 == argc) {
+			std::fprintf(stderr, "Missing value for argument %s\n", argv[i]);
+			return 1;
+		}
+		if (!std::strcmp(argv[i], "--N")) N = std::atoll(argv[i + 1]);
+		else if (!std::strcmp(argv[i], "--runs")) runs = std::atoi(argv[i + 1]);
+		else if (!std::strcmp(argv[i], "--csv")) csv_path = argv[i + 1];
+		else {
+			std::fprintf(stderr, "Unknown argument %s\n", argv[i]);
+			return 1;
+		}
+	}
+
+	const std::int64_t c = std::max<std::int64_t>(1, (std::int64_t)std::llround(std::cbrt((double)N)));
+	const std::int64_t s = std::max<std::int64_t>(1, (std::int64_t)std::llround(std::sqrt(N / 4.0)));
+	const std::int64_t s2 = std::max<std::int64_t>(1, (std::int64_t)std::llround(std::sqrt(N / 2.0)));
+	const std::vector<Shape> shapes = {
+		{ c, c, c }, { 2, s2, s2 }, { 4, s, s }, { s, s, 4 }, { std::max<std::int64_t>(1, N / 3), 3, 1 }, { N, 1, 1 }, { 1, 1, N }
+	};
+
+	std::vector<int> threads = { 1 };
+#ifdef _OPENMP
+	for (int t = 2; t < omp_get_max_threads(); t *= 2) {
+		threads.push_back(t);
+	}
+	if (omp_get_max_threads() > 1) {
+		threads.push_back(omp_get_max_threads());
+	}
+#endif
+
+	FILE* csv = nullptr;
+	if (csv_path) {
+		csv = std::fopen(csv_path, "w");
+		if (!csv) {
+			std::fprintf(stderr, "Unable to write %s\n", csv_path);
+			return 1;
+		}
+		std::fprintf(csv, "variant,dtype,shape,threads,ns,match\n");
+	}
+	run<float>(shapes, threads, runs, csv);
+	run<double>(shapes, threads, runs, csv);
+	if (csv) {
+		std::fclose(csv);
+	}
+	return 0;
+}
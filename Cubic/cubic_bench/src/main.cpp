@@ -0,0 +1,367 @@
+// cubic_bench : Accuracy / performance (Pareto) benchmark of all solver variants.
+//
+// Usage: cubic_bench [--N count] [--runs count] [--seed value] [--csv file] [--json file]
+//
+// Coefficients are drawn uniformly in [-max, max) for max = 1e0 and 1e5 as in 'tests/test_cubic.py'. Every solver
+// variant solves the same batch in parallel (OpenMP), the best time over the runs is reported. Roots are compared
+// with reference roots computed in extended precision (__float128 if CUBIC_FLOAT128 is defined, otherwise long
+// double) by QBC followed by Newton iterations:
+//
+//	Residual	|f(x)| evaluated in extended precision (MAE, Std and Max as in the README tables).
+//	Rel. error	|x - r| / |r| to the closest reference root r (mean and max).
+//	Mismatch	number of equations where the root count differs from the reference.
+//
+// Results are printed as a table and optionally written as CSV and / or JSON (one row per solver and range).
+//
+// Per-call latency of the scalar solvers is measured on a single thread (p50, p99, p99.99 and max over all calls),
+// comparing the unbounded 'cubic_roots_qbc()' with 'cubic_roots_qbc_bounded()'. Each call is timed repeatedly
+// keeping the fastest time, the remaining outliers (max) are preemption of the benchmark thread.
+//
+// The root count statistics of a parameter sweep (x^3 + px + q over a 2D grid of about N points) are computed by
+// materializing the grid, the coefficients and the roots of every equation, and by the fused tiled pipeline
+// 'cubic_root_counts_grid()'. Both report the best time per point and the memory allocated.
+//
+
+#include "cubic/cubic.h"
+#include "cubic/cubic_batch.h"
+#include "cubic/fp_traits.h"
+#include "cubic/grid_pipeline.h"
+#include "cubic/ndgrid.h"
+
+#include<algorithm>
+#include<array>
+#include<chrono>
+#include<cmath>
+#include<cstdint>
+#include<cstdio>
+#include<cstdlib>
+#include<cstring>
+#include<functional>
+#include<random>
+#include<string>
+#include<vector>
+
+
+#ifdef CUBIC_FLOAT128
+typedef __float128 REF;
+static const char* REF_NAME = "__float128";
+#else
+typedef long double REF;
+static const char* REF_NAME = "long double";
+#endif
+
+/* Solves N equations stored row-wise in double precision, output is padded as 'cubic_roots_batch()'. */
+typedef std::function<void(const double* coeffs, std::int64_t N, double* xroots, int* nroots)> BatchSolver;
+
+/* Either a double precision batch solver or a float solver run by 'cubic_roots_batch<float>()', the coefficients
+ * of float variants are converted before and the roots after the timed region. */
+struct Variant {
+	const char* name;
+	BatchSolver solve;
+	CBRT_SOLVER<float> float_solver = nullptr;
+};
+
+struct Result {
+	std::string name;
+	double max;
+	std::int64_t N;
+	double ns;
+	double mae, stddev, emax;
+	double rel_mean, rel_max;
+	std::int64_t mismatch;
+};
+
+
+static std::vector<Variant> variants()
+{
+	return {
+		{ "cubic", [](const double* A, std::int64_t N, double* x, int* n) { cubic_roots_batch<double>(A, N, x, n); } },
+		{ "fast", [](const double* A, std::int64_t N, double* x, int* n) { cubic_roots_batch<double>(A, N, x, n, &cubic_roots_fast<double>); } },
+		{ "qbc", [](const double* A, std::int64_t N, double* x, int* n) { cubic_roots_batch<double>(A, N, x, n, &cubic_roots_qbc<double>); } },
+		{ "classified", [](const double* A, std::int64_t N, double* x, int* n) { cubic_roots_classified<double>(A, N, x, n); } },
+		{ "hybrid", [](const double* A, std::int64_t N, double* x, int* n) { cubic_roots_hybrid<double>(A, N, x, n); } },
+		{ "refined", [](const double* A, std::int64_t N, double* x, int* n) { cubic_roots_refined<double>(A, N, x, n); } },
+		{ "cubic_f32", nullptr, &cubic_roots<float> },
+		{ "fast_f32", nullptr, &cubic_roots_fast<float> },
+		{ "qbc_f32", nullptr, &cubic_roots_qbc<float> },
+	};
+}
+
+/* Reference roots: extended precision QBC polished by Newton iterations. */
+static int reference_roots(const double* A, REF* x)
+{
+	const REF a = A[0], b = A[1], c = A[2], d = A[3];
+	int n = cubic_roots_qbc<REF>(a, b, c, d, x);
+	for (int k = 0; k < n; k++) {
+		for (int it = 0; it < 4; it++) {
+			REF f = ((a * x[k] + b) * x[k] + c) * x[k] + d;
+			REF df = ((REF)3.0 * a * x[k] + (REF)2.0 * b) * x[k] + c;
+			if (df == (REF)0.0) {
+				break;
+			}
+			x[k] -= f / df;
+		}
+	}
+	return n;
+}
+
+static Result evaluate(const Variant& variant, double max, const std::vector<double>& coeffs,
+	const std::vector<REF>& ref, const std::vector<int>& nref, int runs)
+{
+	using namespace std;
+	const std::int64_t N = (std::int64_t)nref.size();
+	std::vector<double> xroots(3 * N);
+	std::vector<int> nroots(N);
+
+	std::vector<float> fcoeffs, froots;
+	if (variant.float_solver) {
+		fcoeffs.assign(coeffs.begin(), coeffs.end());
+		froots.resize(3 * N);
+	}
+
+	double best = INFINITY;
+	for (int r = 0; r < runs; r++) {
+		auto start = std::chrono::high_resolution_clock::now();
+		if (variant.float_solver) {
+			cubic_roots_batch<float>(fcoeffs.data(), N, froots.data(), nroots.data(), variant.float_solver);
+		}
+		else {
+			variant.solve(coeffs.data(), N, xroots.data(), nroots.data());
+		}
+		std::chrono::duration<double, std::nano> duration = std::chrono::high_resolution_clock::now() - start;
+		best = std::min(best, duration.count() / N);
+	}
+	std::copy(froots.begin(), froots.end(), xroots.begin());
+
+	double sum = 0.0, sum2 = 0.0, emax = 0.0, rel_sum = 0.0, rel_max = 0.0;
+	std::int64_t count = 0, mismatch = 0;
+#pragma omp parallel for schedule(static) reduction(+:sum, sum2, rel_sum, count, mismatch) reduction(max:emax, rel_max)
+	for (std::int64_t i = 0; i < N; i++) {
+		const double* A = coeffs.data() + 4 * i;
+		mismatch += nroots[i] != nref[i];
+		for (int k = 0; k < nroots[i]; k++) {
+			const REF x = xroots[3 * i + k];
+			const double res = (double)fabs((((REF)A[0] * x + (REF)A[1]) * x + (REF)A[2]) * x + (REF)A[3]);
+			sum += res;
+			sum2 += res * res;
+			emax = std::max(emax, res);
+			if (nref[i] > 0) {
+				REF err = INFINITY;
+				for (int j = 0; j < nref[i]; j++) {
+					const REF rj = ref[3 * i + j];
+					err = std::min(err, (REF)fabs(x - rj) / (rj != (REF)0.0 ? (REF)fabs(rj) : (REF)1.0));
+				}
+				rel_sum += (double)err;
+				rel_max = std::max(rel_max, (double)err);
+			}
+			count++;
+		}
+	}
+	Result result;
+	result.name = variant.name;
+	result.max = max;
+	result.N = N;
+	result.ns = best;
+	result.mae = sum / count;
+	result.stddev = std::sqrt(std::max(sum2 / count - result.mae * result.mae, 0.0));
+	result.emax = emax;
+	result.rel_mean = rel_sum / count;
+	result.rel_max = rel_max;
+	result.mismatch = mismatch;
+	return result;
+}
+
+/* Each call is timed LATENCY_REPS times keeping the fastest, filtering out interrupts hitting a single measurement. */
+static constexpr int LATENCY_REPS = 3;
+
+/* Latency percentiles in ns of calling solve(i) for i < N, one call at a time. */
+static void latency(const char* name, std::int64_t N, const std::function<void(std::int64_t)>& solve)
+{
+	std::vector<double> ns(N, INFINITY);
+	for (int r = 0; r < LATENCY_REPS; r++) {
+		for (std::int64_t i = 0; i < N; i++) {
+			auto start = std::chrono::steady_clock::now();
+			solve(i);
+			std::chrono::duration<double, std::nano> duration = std::chrono::steady_clock::now() - start;
+			ns[i] = std::min(ns[i], duration.count());
+		}
+	}
+	auto percentile = [&](double p) {
+		std::int64_t k = std::min(N - 1, (std::int64_t)(p * N));
+		std::nth_element(ns.begin(), ns.begin() + k, ns.end());
+		return ns[k];
+	};
+	const double p50 = percentile(0.5), p99 = percentile(0.99), p9999 = percentile(0.9999);
+	std::printf("%s | %.0f | %.0f | %.0f | %.0f", name, p50, p99, p9999, *std::max_element(ns.begin(), ns.end()));
+}
+
+static void latency_table(const std::vector<double>& coeffs)
+{
+	const std::int64_t N = std::min<std::int64_t>((std::int64_t)coeffs.size() / 4, 1000000);
+	const double* A = coeffs.data();
+	double x[3];
+	volatile int sink = 0;
+
+	std::printf("Algo. | p50 (ns) | p99 (ns) | p99.99 (ns) | Max (ns) | Fallback\n");
+	std::printf("--- | --- | --- | --- | --- | ---\n");
+	latency("cubic", N, [&](std::int64_t i) { sink = cubic_roots<double>(A[4 * i], A[4 * i + 1], A[4 * i + 2], A[4 * i + 3], x); });
+	std::printf(" | -\n");
+	latency("qbc", N, [&](std::int64_t i) { sink = cubic_roots_qbc<double>(A[4 * i], A[4 * i + 1], A[4 * i + 2], A[4 * i + 3], x); });
+	std::printf(" | -\n");
+	for (int max_iter : { QBC_MAX_ITER, 6 }) {
+		std::int64_t fallback = 0;
+		const std::string name = "qbc_bounded(" + std::to_string(max_iter) + ")";
+		latency(name.c_str(), N, [&](std::int64_t i) {
+			bool converged;
+			sink = cubic_roots_qbc_bounded<double>(A[4 * i], A[4 * i + 1], A[4 * i + 2], A[4 * i + 3], x, max_iter, &converged);
+			fallback += !converged;
+		});
+		fallback /= LATENCY_REPS;
+		std::printf(" | %lld\n", (long long)fallback);
+	}
+	std::printf("\n");
+	(void)sink;
+}
+
+/* Coefficients of the depressed cubic x^3 + px + q at the grid point (p, q). */
+static void depressed_coefficients(const double* point, double* A)
+{
+	A[0] = 1.0;
+	A[1] = 0.0;
+	A[2] = point[0];
+	A[3] = point[1];
+}
+
+static void pipeline_table(std::int64_t N, int runs)
+{
+	const std::int64_t n = std::max<std::int64_t>(1, (std::int64_t)std::llround(std::sqrt((double)N)));
+	const NdgridView<double, 2> grid({ n, n }, { 6.0, 6.0 });
+	std::array<std::int64_t, 4> counts[2];
+	double best[2] = { INFINITY, INFINITY };
+	for (int r = 0; r < runs; r++) {
+		auto start = std::chrono::high_resolution_clock::now();
+		{
+			const AlignedBuffer<double> points = ndgrid(grid);
+			AlignedBuffer<double> coeffs(4 * grid.size()), xroots(3 * grid.size());
+			AlignedBuffer<int> nroots(grid.size());
+#pragma omp parallel for schedule(static)
+			for (std::int64_t j = 0; j < grid.size(); j++) {
+				depressed_coefficients(points.data() + 2 * j, coeffs.data() + 4 * j);
+			}
+			cubic_roots_batch<double>(coeffs.data(), grid.size(), xroots.data(), nroots.data());
+			counts[0] = { 0, 0, 0, 0 };
+			for (int k : nroots) {
+				counts[0][k]++;
+			}
+		}
+		std::chrono::duration<double, std::nano> duration = std::chrono::high_resolution_clock::now() - start;
+		best[0] = std::min(best[0], duration.count() / grid.size());
+
+		start = std::chrono::high_resolution_clock::now();
+		counts[1] = cubic_root_counts_grid(grid, &depressed_coefficients);
+		duration = std::chrono::high_resolution_clock::now() - start;
+		best[1] = std::min(best[1], duration.count() / grid.size());
+	}
+	const double materialized_mb = grid.size() * (9 * sizeof(double) + sizeof(int)) / 1e6;
+	const double tiled_mb = GRID_TILE_SIZE * (9 * sizeof(double) + sizeof(int)) / 1e6;
+	std::printf("Root counts of x^3 + px + q | %lldx%lld grid\n\n", (long long)n, (long long)n);
+	std::printf("Pipeline | ns | Memory (MB) | 1 root | 3 roots\n");
+	std::printf("--- | --- | --- | --- | ---\n");
+	std::printf("materialized | %.2f | %.1f | %lld | %lld\n", best[0], materialized_mb, (long long)counts[0][1], (long long)counts[0][3]);
+	std::printf("fused | %.2f | %.2f per thread | %lld | %lld\n\n", best[1], tiled_mb, (long long)counts[1][1], (long long)counts[1][3]);
+}
+
+static void write_csv(const char* path, const std::vector<Result>& results)
+{
+	FILE* f = std::fopen(path, "w");
+	if (!f) {
+		std::fprintf(stderr, "Unable to write %s\n", path);
+		return;
+	}
+	std::fprintf(f, "solver,max,N,ns,mae,std,emax,rel_mean,rel_max,mismatch\n");
+	for (const Result& r : results) {
+		std::fprintf(f, "%s,%g,%lld,%.4f,%.17g,%.17g,%.17g,%.17g,%.17g,%lld\n", r.name.c_str(), r.max, (long long)r.N,
+			r.ns, r.mae, r.stddev, r.emax, r.rel_mean, r.rel_max, (long long)r.mismatch);
+	}
+	std::fclose(f);
+}
+
+static void write_json(const char* path, const std::vector<Result>& results)
+{
+	FILE* f = std::fopen(path, "w");
+	if (!f) {
+		std::fprintf(stderr, "Unable to write %s\n", path);
+		return;
+	}
+	std::fprintf(f, "{\n  \"reference\": \"%s\",\n  \"results\": [\n", REF_NAME);
+	for (std::size_t i = 0; i < results.size(); i++) {
+		const Result& r = results[i];
+		std::fprintf(f, "    {\"solver\": \"%s\", \"max\": %g, \"N\": %lld, \"ns\": %.4f, \"mae\": %.17g, \"std\": %.17g, "
+			"\"emax\": %.17g, \"rel_mean\": %.17g, \"rel_max\": %.17g, \"mismatch\": %lld}%s\n",
+			r.name.c_str(), r.max, (long long)r.N, r.ns, r.mae, r.stddev, r.emax, r.rel_mean, r.rel_max,
+			(long long)r.mismatch, i + 1 < results.size() ? "," : "");
+	}
+	std::fprintf(f, "  ]\n}\n");
+	std::fclose(f);
+}
+
+
+int main(int argc, char* argv[])
+{
+	std::int64_t N = 1000000;
+	int runs = 3;
+	unsigned seed = 235201124;
+	const char* csv = nullptr;
+	const char* json = nullptr;
+	for (int i = 1; i < argc; i += 2) {
+		if (i + 1 == argc) {
+			std::fprintf(stderr, "Missing value for argument %s\n", argv[i]);
+			return 1;
+		}
+		if (!std::strcmp(argv[i], "--N")) N = std::atoll(argv[i + 1]);
+		else if (!std::strcmp(argv[i], "--runs")) runs = std::atoi(argv[i + 1]);
+		else if (!std::strcmp(argv[i], "--seed")) seed = (unsigned)std::atoll(argv[i + 1]);
+		else if (!std::strcmp(argv[i], "--csv")) csv = argv[i + 1];
+		else if (!std::strcmp(argv[i], "--json")) json = argv[i + 1];
+		else {
+			std::fprintf(stderr, "Unknown argument %s\n", argv[i]);
+			return 1;
+		}
+	}
+
+	std::vector<Result> results;
+	for (double max : { 1e0, 1e5 }) {
+		std::default_random_engine e1(seed);
+		std::uniform_real_distribution<double> uniform_dist(-max, max);
+		std::vector<double> coeffs(4 * N);
+		for (double& c : coeffs) {
+			c = uniform_dist(e1);
+		}
+		std::vector<REF> ref(3 * N);
+		std::vector<int> nref(N);
+#pragma omp parallel for schedule(dynamic, 1024)
+		for (std::int64_t i = 0; i < N; i++) {
+			nref[i] = reference_roots(coeffs.data() + 4 * i, ref.data() + 3 * i);
+		}
+
+		std::printf("Coefficients in [-%.0E, %.0E) | N %lld | Reference %s\n\n", max, max, (long long)N, REF_NAME);
+		std::printf("Algo. | ns | MAE | Std | Max | Rel. mean | Rel. max | Mismatch\n");
+		std::printf("--- | --- | --- | --- | --- | --- | --- | ---\n");
+		for (const Variant& variant : variants()) {
+			Result r = evaluate(variant, max, coeffs, ref, nref, runs);
+			std::printf("%s | %.2f | %.16f | %.16f | %.16f | %.3E | %.3E | %lld\n", r.name.c_str(), r.ns, r.mae, r.stddev,
+				r.emax, r.rel_mean, r.rel_max, (long long)r.mismatch);
+			results.push_back(r);
+		}
+		std::printf("\n");
+		latency_table(coeffs);
+	}
+	pipeline_table(N, runs);
+	if (csv) {
+		write_csv(csv, results);
+	}
+	if (json) {
+		write_json(json, results);
+	}
+	return 0;
+}
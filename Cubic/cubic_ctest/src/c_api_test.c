@@ -0,0 +1,92 @@
+/* Test of the 'libcubic' shared library through its C API only, compiled as C and linked against the shared
+* library (catches missing exports and C incompatible declarations in 'cubic/cubic_c.h').
+*
+* Provided under the Unlicense License (public domain, see license terms at http://unlicense.org/).
+*/
+#include "cubic/cubic_c.h"
+
+#include<math.h>
+#include<stdio.h>
+#include<stdlib.h>
+
+
+static int failures = 0;
+
+static void check(int condition, const char* what)
+{
+	if (!condition) {
+		fprintf(stderr, "FAILED: %s\n", what);
+		failures++;
+	}
+}
+
+/* Check the roots in x (any order) are 1, 2 and 3 to the tolerance. */
+static int roots_123(const double* x, double tol)
+{
+	int found = 0;
+	for (int k = 0; k < 3; k++) {
+		for (int j = 1; j <= 3; j++) {
+			if (fabs(x[k] - j) <= tol * j) {
+				found |= 1 << j;
+			}
+		}
+	}
+	return found == (1 << 1 | 1 << 2 | 1 << 3);
+}
+
+int main(void)
+{
+	/* (x - 1)(x - 2)(x - 3) */
+	double x[3];
+	float xf[3];
+	double xd[3];
+	int converged = 0;
+	check(cubic_abi_version() == CUBIC_ABI_VERSION, "cubic_abi_version");
+
+	check(cubic_roots_d(1, -6, 11, -6, x) == 3 && roots_123(x, 1e-12), "cubic_roots_d");
+	check(cubic_roots_qbc_d(1, -6, 11, -6, x) == 3 && roots_123(x, 1e-14), "cubic_roots_qbc_d");
+	check(cubic_roots_qbc_bounded_d(1, -6, 11, -6, x, 16, &converged) == 3 && converged && roots_123(x, 1e-14),
+		"cubic_roots_qbc_bounded_d");
+	check(cubic_roots_f(1, -6, 11, -6, xf) == 3, "cubic_roots_f");
+	for (int k = 0; k < 3; k++) {
+		xd[k] = xf[k];
+	}
+	check(roots_123(xd, 1e-5), "cubic_roots_f");
+
+	/* x^2 - 3x + 2 */
+	check(quadratic_roots_d(1, -3, 2, x) == 2 && fabs(x[0] + x[1] - 3) <= 1e-14, "quadratic_roots_d");
+	check(qdrtc_f(1, -3, 2, xf) == 2 && fabs(xf[0] + xf[1] - 3) <= 1e-6, "qdrtc_f");
+
+	/* Batch: alternating (x - 1)(x - 2)(x - 3) and x^3 + 1 */
+	enum { N = 1000 };
+	double* coeffs = malloc(4 * N * sizeof(double));
+	double* xroots = malloc(3 * N * sizeof(double));
+	int* nroots = malloc(N * sizeof(int));
+	for (int i = 0; i < N; i++) {
+		const double A[2][4] = { { 1, -6, 11, -6 }, { 1, 0, 0, 1 } };
+		for (int j = 0; j < 4; j++) {
+			coeffs[4 * i + j] = A[i % 2][j];
+		}
+	}
+	cubic_set_num_threads(2);
+	check(cubic_get_max_threads() == 2 || cubic_get_max_threads() == 1, "cubic_set_num_threads");
+	cubic_roots_qbc_batch_d(coeffs, N, xroots, nroots);
+	for (int i = 0; i < N; i++) {
+		if (i % 2 == 0) {
+			check(nroots[i] == 3 && roots_123(xroots + 3 * i, 1e-14), "cubic_roots_qbc_batch_d");
+		}
+		else {
+			check(nroots[i] == 1 && fabs(xroots[3 * i] + 1) <= 1e-14, "cubic_roots_qbc_batch_d");
+		}
+	}
+	free(coeffs);
+	free(xroots);
+	free(nroots);
+
+	if (failures) {
+		fprintf(stderr, "%d C API checks failed.\n", failures);
+		return 1;
+	}
+	printf("C API tests passed.\n");
+	return 0;
+}
@@ -3,13 +3,31 @@
 
 
 #include "cubic/cubic.h"
+#include "cubic/cubic_batch.h"
+#include "cubic/cubic_c.h"
+#include "cubic/cubic_constexpr.h"
+#include "cubic/fast_math.h"
+#include "cubic/fp_traits.h"
+#include "cubic/poly_eval.h"
+#include "cubic/eft.h"
+#include "cubic/cubic_service.h"
+#include "cubic/eig3.h"
+#include "cubic/grid_pipeline.h"
+#include "cubic/ndgrid.h"
 
 #include<array>
+#include<vector>
+#include<complex>
+#include<limits>
+#include<float.h>
 #include<stdexcept>
 #include<assert.h>
 #include <random>
 #include <chrono>
 #include<iostream>
+#include<cstdio>
+#include<thread>
+#include<atomic>
 
 template<typename FP>
 void assert_zero(FP val) {
@@ -102,6 +120,834 @@ static void testcases(CBRT_SOLVER<FP> cbrt_solver) {
 	val = cubic(20200.51346605, -9670.18955856, -81125.76266827, -51384.96475652, out[2]);
 }
 
+/* Test 'cubic_roots_csr()' produces the same roots as the padded batch and scalar solver.
+*/
+template<typename FP>
+static void test_cubic_csr(CBRT_SOLVER<FP> cbrt_solver, std::int64_t N = 100000, int seed = 235201124) {
+	std::default_random_engine e1(seed);
+	std::uniform_real_distribution<FP> uniform_dist(-1.0, 1.0);
+	std::vector<FP> coeffs(4 * N);
+	for (FP& c : coeffs) {
+		c = uniform_dist(e1);
+	}
+	/* Some equations with three real roots. */
+	for (std::int64_t i = 0; i < N; i += 7) {
+		coeffs[4 * i + 0] = 1.0;
+		coeffs[4 * i + 1] = -6.0;
+		coeffs[4 * i + 2] = 11.0;
+		coeffs[4 * i + 3] = -6.0;
+	}
+
+	std::vector<FP> padded(3 * N);
+	std::vector<int> nroots(N);
+	cubic_roots_batch<FP>(coeffs.data(), N, padded.data(), nroots.data(), cbrt_solver);
+
+	std::vector<FP> roots;
+	std::vector<std::int64_t> offsets(N + 1);
+	std::int64_t total = cubic_roots_csr<FP>(coeffs.data(), N, roots, offsets.data(), cbrt_solver);
+	assert_zero<std::int64_t>(total - (std::int64_t)roots.size());
+	assert_zero<std::int64_t>(offsets[N] - total);
+
+	for (std::int64_t i = 0; i < N; i++) {
+		assert_zero<std::int64_t>(offsets[i + 1] - offsets[i] - nroots[i]);
+		for (int k = 0; k < nroots[i]; k++) {
+			assert_zero<FP>(roots[offsets[i] + k] - padded[3 * i + k]);
+		}
+	}
+}
+/* Test monic and depressed solvers match 'cubic_roots()' with a = 1 (and b = 0).
+*/
+template<typename FP>
+static void test_monic_depressed(std::int64_t N = 100000, int seed = 235201124) {
+	std::default_random_engine e1(seed);
+	std::uniform_real_distribution<FP> uniform_dist(-1.0, 1.0);
+	std::vector<FP> monic(3 * N), depressed(2 * N);
+	for (FP& c : monic) {
+		c = uniform_dist(e1);
+	}
+	for (FP& c : depressed) {
+		c = uniform_dist(e1);
+	}
+	/* Zero constant term */
+	monic[2] = 0.0;
+	depressed[1] = 0.0;
+
+	std::vector<FP> roots(3 * N);
+	std::vector<int> nroots(N);
+	FP out[3];
+	monic_cubic_roots_batch<FP>(monic.data(), N, roots.data(), nroots.data());
+	for (std::int64_t i = 0; i < N; i++) {
+		const FP* A = monic.data() + 3 * i;
+		int n = cubic_roots<FP>(1.0, A[0], A[1], A[2], out);
+		assert_zero(n - nroots[i]);
+		for (int k = 0; k < n; k++) {
+			assert_zero(out[k] - roots[3 * i + k]);
+		}
+	}
+	depressed_cubic_roots_batch<FP>(depressed.data(), N, roots.data(), nroots.data());
+	for (std::int64_t i = 0; i < N; i++) {
+		const FP* A = depressed.data() + 2 * i;
+		int n = cubic_roots<FP>(1.0, 0.0, A[0], A[1], out);
+		assert_zero(n - nroots[i]);
+		for (int k = 0; k < n; k++) {
+			assert_zero(out[k] - roots[3 * i + k]);
+		}
+	}
+}
+
+/* Compile time evaluation of the constexpr solvers.
+*/
+constexpr Roots<double, 3> ce_roots = cubic_roots_ce(1.0, -6.0, 11.0, -6.0);
+static_assert(ce_roots.n == 3, "Expected three real roots.");
+static_assert(ce::abs(ce_roots[0] - 3.0) < 1e-12 && ce::abs(ce_roots[1] - 2.0) < 1e-12 && ce::abs(ce_roots[2] - 1.0) < 1e-12, "Incorrect roots.");
+static_assert(cubic_roots_ce(1.0, 0.0, 1.0, -2.0).n == 1 && ce::abs(cubic_roots_ce(1.0, 0.0, 1.0, -2.0)[0] - 1.0) < 1e-12, "Incorrect root.");
+static_assert(qdrtc_ce(1.0f, -3.0f, 2.0f).n == 2 && ce::abs(qdrtc_ce(1.0f, -3.0f, 2.0f)[1] - 2.0f) < 1e-6f, "Incorrect roots.");
+
+/* Test the constexpr solvers agree with the runtime solvers.
+*/
+template<typename FP>
+static void test_constexpr(std::size_t N = 100000, int seed = 235201124) {
+	std::default_random_engine e1(seed);
+	std::uniform_real_distribution<FP> uniform_dist(-1.0, 1.0);
+	for (std::size_t i = 0; i < N; i++) {
+		FP A = uniform_dist(e1);
+		FP B = uniform_dist(e1);
+		FP C = uniform_dist(e1);
+		FP D = uniform_dist(e1);
+
+		FP out[3];
+		int n = cubic_roots<FP>(A, B, C, D, out);
+		Roots<FP, 3> r = cubic_roots_ce<FP>(A, B, C, D);
+		assert_zero(n - r.n);
+		/* Roots may differ for ill-conditioned equations, tolerance is relative to a bound on the root magnitude. */
+		FP M = (FP)1.0 + std::abs(B / A) + std::sqrt(std::abs(C / A)) + std::cbrt(std::abs(D / A));
+		for (int k = 0; k < n; k++) {
+			if (std::abs(out[k] - r[k]) > (FP)1024.0 * std::numeric_limits<FP>::epsilon() * M) {
+				throw std::runtime_error("Constexpr root mismatch.");
+			}
+		}
+
+		n = qdrtc<FP>(A, B, C, out);
+		Roots<FP, 2> q = qdrtc_ce<FP>(A, B, C);
+		assert_zero(n - q.n);
+		for (int k = 0; k < n; k++) {
+			if (std::abs(out[k] - q[k]) > (FP)4.0 * std::numeric_limits<FP>::epsilon() * std::abs(out[k])) {
+				throw std::runtime_error("Constexpr root mismatch.");
+			}
+		}
+	}
+}
+
+/* Error of x in ULP relative to a reference value ref.
+*/
+template<typename FP>
+static long double ulp_error(FP x, long double ref, long double ref_scale) {
+	FP a = (FP)std::abs(ref_scale);
+	return std::abs(x - ref) / (std::nextafter(a, std::numeric_limits<FP>::infinity()) - a);
+}
+
+/* Test the approximations in 'fast_math.h' are within the documented ULP bounds.
+*/
+template<typename FP>
+static void test_fast_math(long double acos_ulp, long double sincos_ulp, long double cbrt_ulp, std::size_t N = 1000000, int seed = 235201124) {
+	std::default_random_engine e1(seed);
+	std::uniform_real_distribution<double> uniform_dist(-1.0, 1.0);
+	for (std::size_t i = 0; i < N; i++) {
+		FP x = (FP)uniform_dist(e1);
+		long double ref = std::acos((long double)x);
+		if (ulp_error(fast::acos(x), ref, ref) > acos_ulp) {
+			throw std::runtime_error("fast::acos() exceeds error bound.");
+		}
+
+		FP t = (FP)(uniform_dist(e1) * 1.0471975511965976);
+		FP s, c;
+		fast::sincos(t, s, c);
+		long double ref_s = std::sin((long double)t), ref_c = std::cos((long double)t);
+		long double ref_m = std::fmax(std::abs(ref_s), std::abs(ref_c));
+		if (ulp_error(s, ref_s, ref_m) > sincos_ulp || ulp_error(c, ref_c, ref_m) > sincos_ulp) {
+			throw std::runtime_error("fast::sincos() exceeds error bound.");
+		}
+
+		/* Full normal range of FP, subnormals are computed by std::cbrt(). */
+		FP y = (FP)std::ldexp(uniform_dist(e1), (int)(uniform_dist(e1) * (std::numeric_limits<FP>::max_exponent - 3)));
+		ref = std::cbrt((long double)y);
+		if (std::abs(y) >= std::numeric_limits<FP>::min() && ulp_error(fast::cbrt(y), ref, ref) > cbrt_ulp) {
+			throw std::runtime_error("fast::cbrt() exceeds error bound.");
+		}
+	}
+}
+
+/* Compute MAE, Std and Max of the absolute error |f(x_r)| for all real roots x_r over N polynomials
+* with coefficients uniformly drawn in [-max, max) (same statistics as the README tables).
+*/
+template<typename FP>
+static std::array<double, 3> accuracy_test_instance(CBRT_SOLVER<FP> cbrt_solver, FP max, std::size_t N, int seed)
+{
+	std::default_random_engine e1(seed);
+	std::uniform_real_distribution<FP> uniform_dist(-max, max);
+
+	double sum = 0.0, sum_sq = 0.0, emax = 0.0;
+	std::size_t count = 0;
+	for (std::size_t i = 0; i < N; i++)
+	{
+		FP A = uniform_dist(e1);
+		FP B = uniform_dist(e1);
+		FP C = uniform_dist(e1);
+		FP D = uniform_dist(e1);
+
+		FP out[3];
+		int n = cbrt_solver(A, B, C, D, out);
+		for (int k = 0; k < n; k++) {
+			double e = std::abs((double)cubic<FP>(A, B, C, D, out[k]));
+			sum += e;
+			sum_sq += e * e;
+			emax = std::fmax(emax, e);
+		}
+		count += n;
+	}
+	double mae = sum / count;
+	return { mae, std::sqrt(std::fmax(sum_sq / count - mae * mae, 0.0)), emax };
+}
+
+template<typename FP>
+static void run_accuracy_test(CBRT_SOLVER<FP> cbrt_solver, const char* func_name, FP max, std::size_t N = 1000000, int seed = 235201124)
+{
+	std::array<double, 3> res = accuracy_test_instance(cbrt_solver, max, N, seed);
+	std::printf(" | %s | Max %.0E | MAE: %0.16f | Std: %0.16f | Max: %0.16f |\n", func_name, (double)max, res[0], res[1], res[2]);
+}
+
+/* Test the fast solver error stays within a small factor of 'cubic_roots()'.
+*/
+template<typename FP>
+static void test_fast_accuracy(FP max, std::size_t N = 100000, int seed = 235201124) {
+	std::array<double, 3> ref = accuracy_test_instance<FP>(&cubic_roots<FP>, max, N, seed);
+	std::array<double, 3> res = accuracy_test_instance<FP>(&cubic_roots_fast<FP>, max, N, seed);
+	if (res[0] > 2.0 * ref[0]) {
+		throw std::runtime_error("Fast solver MAE exceeds error budget.");
+	}
+}
+
+/* Test 'cubic_roots_hybrid()' returns closed form roots for lanes passing the residual check and QBC roots otherwise.
+*/
+template<typename FP>
+static void test_hybrid(FP max, std::int64_t N = 100000, int seed = 235201124) {
+	std::default_random_engine e1(seed);
+	std::uniform_real_distribution<FP> uniform_dist(-max, max);
+	std::vector<FP> coeffs(4 * N);
+	for (FP& c : coeffs) {
+		c = uniform_dist(e1);
+	}
+
+	std::vector<FP> roots(3 * N);
+	std::vector<int> nroots(N);
+	std::int64_t nfallback = cubic_roots_hybrid<FP>(coeffs.data(), N, roots.data(), nroots.data());
+
+	std::int64_t nqbc = 0;
+	double err_hybrid = 0.0, err_cubic = 0.0;
+	for (std::int64_t i = 0; i < N; i++) {
+		const FP* A = coeffs.data() + 4 * i;
+		FP cf[3], qbc[3];
+		int ncf = cubic_roots<FP>(A[0], A[1], A[2], A[3], cf);
+		int nq = cubic_roots_qbc<FP>(A[0], A[1], A[2], A[3], qbc);
+		bool is_cf = ncf == nroots[i], is_qbc = nq == nroots[i];
+		for (int k = 0; k < nroots[i]; k++) {
+			is_cf = is_cf && cf[k] == roots[3 * i + k];
+			is_qbc = is_qbc && qbc[k] == roots[3 * i + k];
+			err_hybrid += std::abs(cubic<FP>(A[0], A[1], A[2], A[3], roots[3 * i + k]));
+		}
+		for (int k = 0; k < ncf; k++) {
+			err_cubic += std::abs(cubic<FP>(A[0], A[1], A[2], A[3], cf[k]));
+		}
+		if (!is_cf && !is_qbc) {
+			throw std::runtime_error("Hybrid root mismatch.");
+		}
+		nqbc += !is_cf;
+	}
+	if (nqbc > nfallback || err_hybrid > err_cubic) {
+		throw std::runtime_error("Hybrid solver error.");
+	}
+}
+
+/* Test the batch polynomial evaluators against the scalar 'cubic()' / 'quadratic()' and compensated functions.
+*/
+template<typename FP>
+static void test_poly_eval(std::int64_t N = 100000, int seed = 235201124) {
+	std::default_random_engine e1(seed);
+	std::uniform_real_distribution<FP> uniform_dist(-1.0, 1.0);
+	std::vector<FP> C(4 * N), x(N), f(N), df(N);
+	for (FP& c : C) {
+		c = uniform_dist(e1);
+	}
+	for (FP& xi : x) {
+		xi = (FP)4.0 * uniform_dist(e1);
+	}
+	const FP* a = C.data(), * b = a + N, * c = b + N, * d = c + N;
+	const FP tol = (FP)16.0 * std::numeric_limits<FP>::epsilon();
+
+	for (bool compensated : { false, true }) {
+		cubic_eval_soa<FP>(a, b, c, d, x.data(), N, f.data(), df.data(), compensated);
+		for (std::int64_t i = 0; i < N; i++) {
+			const FP X = x[i], scale = ((std::abs(a[i]) * std::abs(X) + std::abs(b[i])) * std::abs(X) + std::abs(c[i])) * std::abs(X) + std::abs(d[i]);
+			const FP ref = compensated ? cubic_compensated(a[i], b[i], c[i], d[i], X) : cubic<FP>(a[i], b[i], c[i], d[i], X);
+			const FP dref = ((FP)3.0 * a[i] * X + (FP)2.0 * b[i]) * X + c[i];
+			const FP dscale = ((FP)3.0 * std::abs(a[i]) * std::abs(X) + (FP)2.0 * std::abs(b[i])) * std::abs(X) + std::abs(c[i]);
+			if ((compensated ? f[i] != ref : std::abs(f[i] - ref) > tol * scale) || std::abs(df[i] - dref) > tol * dscale) {
+				throw std::runtime_error("Cubic batch evaluation error.");
+			}
+		}
+		cubic_eval_points<FP>(a[0], b[0], c[0], d[0], x.data(), N, f.data(), nullptr, compensated);
+		for (std::int64_t i = 0; i < N; i++) {
+			const FP ref = compensated ? cubic_compensated(a[0], b[0], c[0], d[0], x[i]) : cubic<FP>(a[0], b[0], c[0], d[0], x[i]);
+			if (std::abs(f[i] - ref) > tol * (FP)256.0) {
+				throw std::runtime_error("Cubic point evaluation error.");
+			}
+		}
+		quadratic_eval_soa<FP>(a, b, c, x.data(), N, f.data(), df.data(), compensated);
+		for (std::int64_t i = 0; i < N; i++) {
+			const FP ref = compensated ? quadratic_compensated(a[i], b[i], c[i], x[i]) : quadratic<FP>(a[i], b[i], c[i], x[i]);
+			if (std::abs(f[i] - ref) > tol * (FP)32.0 || std::abs(df[i] - ((FP)2.0 * a[i] * x[i] + b[i])) > tol * (FP)16.0) {
+				throw std::runtime_error("Quadratic batch evaluation error.");
+			}
+		}
+		quadratic_eval_points<FP>(a[0], b[0], c[0], x.data(), N, f.data(), df.data(), compensated);
+		for (std::int64_t i = 0; i < N; i++) {
+			if (std::abs(f[i] - quadratic<FP>(a[0], b[0], c[0], x[i])) > tol * (FP)32.0) {
+				throw std::runtime_error("Quadratic point evaluation error.");
+			}
+		}
+	}
+}
+
+/* Test 'cubic_roots_refined()' on near-multiple roots 1, 1 + 2^-m and 2 (coefficients exactly representable),
+ * the near-multiple pair should be accurate to a few ULP.
+*/
+static void test_refined() {
+	for (int m : { 8, 16, 20, 26, 30 }) {
+		const double h = std::ldexp(1.0, -m);
+		const double r[3] = { 1.0, 1.0 + h, 2.0 };
+		const double A[4] = { 1.0, -(r[0] + r[1] + r[2]), r[0] * r[1] + r[0] * r[2] + r[1] * r[2], -r[0] * r[1] * r[2] };
+		double x[3];
+		int n;
+		if (cubic_roots_refined<double>(A, 1, x, &n) != 1 || n != 3) {
+			throw std::runtime_error("Near-multiple roots not refined.");
+		}
+		for (int k = 0; k < n; k++) {
+			double err = std::fmin(std::abs(x[k] - r[0]), std::abs(x[k] - r[1]));
+			if (x[k] < 1.5 && err > 4.0 * DBL_EPSILON) {
+				throw std::runtime_error("Refined root error.");
+			}
+		}
+	}
+}
+
+/* Test 'cubic_roots_qbc_bounded()' matches 'cubic_roots_qbc()' when converged and 'cubic_roots()' otherwise.
+*/
+template<typename FP>
+static void test_qbc_bounded(FP max) {
+	std::default_random_engine e1(235201124);
+	std::uniform_real_distribution<FP> uniform_dist(-max, max);
+	for (int i = 0; i < 100000; i++) {
+		FP A[4], x[3], y[3];
+		for (FP& a : A) {
+			a = uniform_dist(e1);
+		}
+		for (int max_iter : { QBC_MAX_ITER, 0 }) {
+			bool converged = false;
+			int n = cubic_roots_qbc_bounded<FP>(A[0], A[1], A[2], A[3], x, max_iter, &converged);
+			int m = converged ? cubic_roots_qbc<FP>(A[0], A[1], A[2], A[3], y) : cubic_roots<FP>(A[0], A[1], A[2], A[3], y);
+			if ((max_iter == QBC_MAX_ITER && !converged) || n != m) {
+				throw std::runtime_error("Bounded QBC convergence.");
+			}
+			for (int k = 0; k < n; k++) {
+				if (x[k] != y[k]) {
+					throw std::runtime_error("Bounded QBC roots.");
+				}
+			}
+		}
+	}
+}
+
+/* Test every 'ndgrid()' strategy generates the expected coordinates.
+*/
+template<typename FP, std::int64_t ndim>
+static void test_ndgrid(std::array<std::int64_t, ndim> shape) {
+	std::array<FP, ndim> size;
+	std::int64_t nelem = 1;
+	for (std::int64_t i = 0; i < ndim; i++) {
+		size[i] = (FP)(i + 1);
+		nelem *= shape[i];
+	}
+	for (NdgridStrategy strategy : { NdgridStrategy::AUTO, NdgridStrategy::ROWS, NdgridStrategy::SLICE_COPY, NdgridStrategy::PARALLEL_TILES }) {
+		const AlignedBuffer<FP> data = ndgrid<FP, ndim>(shape, size, strategy);
+		if ((std::uintptr_t)data.data() % CACHE_LINE_SIZE != 0) {
+			throw std::runtime_error("Grid not aligned.");
+		}
+		for (std::int64_t j = 0; j < nelem; j++) {
+			std::int64_t rem = j;
+			for (std::int64_t i = ndim - 1; i >= 0; i--) {
+				const std::int64_t index = rem % shape[i];
+				rem /= shape[i];
+				const FP expected = shape[i] > 1 ? (index - (shape[i] - 1) / (FP)2.0) * (size[i] / (shape[i] - 1)) : (FP)0.0;
+				if (data[ndim * j + i] != expected) {
+					throw std::runtime_error("Grid coordinate mismatch.");
+				}
+			}
+		}
+	}
+	/* Lazy view: random access and fill of arbitrary sub-ranges match the materialized grid. */
+	const NdgridView<FP, ndim> view(shape, size);
+	const AlignedBuffer<FP> data = ndgrid<FP, ndim>(shape, size);
+	std::vector<FP> buffer(ndim * view.size());
+	for (std::int64_t start : { (std::int64_t)0, view.size() / 3, view.size() - 1 }) {
+		const IndexRange points(start, std::min<std::int64_t>(view.size() - start, 1 + view.size() / 2));
+		view.fill(points, buffer.data());
+		for (std::int64_t j = 0; j < points.size(); j++) {
+			const std::array<FP, ndim> point = view[points[j]];
+			for (std::int64_t i = 0; i < ndim; i++) {
+				if (buffer[ndim * j + i] != data[ndim * points[j] + i] || point[i] != data[ndim * points[j] + i]) {
+					throw std::runtime_error("Grid view coordinate mismatch.");
+				}
+			}
+		}
+		/* Planes of the sub-range. */
+		view.fill_planes(points, buffer.data(), points.size());
+		for (std::int64_t j = 0; j < points.size(); j++) {
+			for (std::int64_t i = 0; i < ndim; i++) {
+				if (buffer[i * points.size() + j] != data[ndim * points[j] + i]) {
+					throw std::runtime_error("Grid view plane mismatch.");
+				}
+			}
+		}
+	}
+	/* Structure-of-arrays layout. */
+	const NdgridPlanes<FP, ndim> planes = ndgrid_planes<FP, ndim>(shape, size);
+	for (std::int64_t i = 0; i < ndim; i++) {
+		if ((std::uintptr_t)planes.plane(i) % CACHE_LINE_SIZE != 0) {
+			throw std::runtime_error("Grid plane not aligned.");
+		}
+		for (std::int64_t j = 0; j < nelem; j++) {
+			if (planes.plane(i)[j] != data[ndim * j + i]) {
+				throw std::runtime_error("Grid plane mismatch.");
+			}
+		}
+	}
+}
+
+/* Test alignment, first touch zeroing and ownership transfer of 'AlignedBuffer'.
+*/
+static void test_aligned_buffer() {
+	AllocConfig config;
+	config.first_touch_items = 1000;
+	AlignedBuffer<double> buffer(12345, config);
+	if ((std::uintptr_t)buffer.data() % CACHE_LINE_SIZE != 0) {
+		throw std::runtime_error("Buffer not aligned.");
+	}
+	for (double v : buffer) {
+		if (v != 0.0) {
+			throw std::runtime_error("Buffer not zeroed.");
+		}
+	}
+	const double* data = buffer.data();
+	AlignedBuffer<double> moved = std::move(buffer);
+	if (moved.data() != data || moved.size() != 12345 || !buffer.empty()) {
+		throw std::runtime_error("Buffer not moved.");
+	}
+
+	AllocConfig huge;
+	huge.huge_pages = true;
+	const AlignedBuffer<float> pages(1 << 20, huge);
+	if ((std::uintptr_t)pages.data() % HUGE_PAGE_SIZE != 0) {
+		throw std::runtime_error("Buffer not aligned to huge pages.");
+	}
+}
+
+/* Test the chunked parameter sweep 'cubic_roots_grid()' against solving the materialized grid.
+*/
+template<typename FP>
+static void test_cubic_roots_grid() {
+	const std::array<std::int64_t, 4> shape = { 5, 7, 9, 11 };
+	const std::array<FP, 4> size = { (FP)2.0, (FP)4.0, (FP)6.0, (FP)8.0 };
+	const NdgridView<FP, 4> grid(shape, size);
+	const AlignedBuffer<FP> coeffs = ndgrid(grid);
+	std::vector<FP> xroots(3 * grid.size());
+	std::vector<int> nroots(grid.size());
+	cubic_roots_batch<FP>(coeffs.data(), grid.size(), xroots.data(), nroots.data());
+
+	std::int64_t next = 0;
+	cubic_roots_grid<FP>(grid, 1000, [&](IndexRange chunk, const FP* A, const FP* x, const int* n) {
+		if (chunk.start() != next || chunk.size() > 1000) {
+			throw std::runtime_error("Grid chunk order.");
+		}
+		next = chunk.one_after_last();
+		for (std::int64_t j = 0; j < chunk.size(); j++) {
+			const std::int64_t i = chunk[j];
+			/* Bitwise, some degenerate equations (e.g. b = c = d = 0) give NaN roots. */
+			if (n[j] != nroots[i] || std::memcmp(A + 4 * j, coeffs.data() + 4 * i, 4 * sizeof(FP)) != 0
+				|| std::memcmp(x + 3 * j, xroots.data() + 3 * i, n[j] * sizeof(FP)) != 0) {
+				throw std::runtime_error("Grid roots mismatch.");
+			}
+		}
+	});
+	if (next != grid.size()) {
+		throw std::runtime_error("Grid not covered.");
+	}
+}
+
+/* Test the fused pipeline 'cubic_roots_grid_reduce()' against the chunked sweep 'cubic_roots_grid()'.
+*/
+template<typename FP>
+static void test_grid_reduce() {
+	const NdgridView<FP, 4> grid({ 5, 7, 9, 11 }, { (FP)2.0, (FP)4.0, (FP)6.0, (FP)8.0 });
+	std::array<std::int64_t, 4> expected = { 0, 0, 0, 0 };
+	std::int64_t index_sum = 0;
+	cubic_roots_grid<FP>(grid, 1000, [&](IndexRange chunk, const FP*, const FP*, const int* n) {
+		for (std::int64_t j = 0; j < chunk.size(); j++) {
+			expected[n[j]]++;
+			index_sum += n[j] == 3 ? chunk[j] : 0;
+		}
+	});
+	auto identity = [](const FP* point, FP* A) { std::copy(point, point + 4, A); };
+	for (std::int64_t tile_size : { (std::int64_t)1, (std::int64_t)100, GRID_TILE_SIZE }) {
+		if (cubic_root_counts_grid(grid, identity, tile_size) != expected) {
+			throw std::runtime_error("Grid root counts mismatch.");
+		}
+		/* Reduction receiving the grid point index and the equation, runs in parallel (no throw). */
+		std::atomic<std::int64_t> mismatch(0);
+		const std::int64_t sum = cubic_roots_grid_reduce(grid, identity, (std::int64_t)0,
+			[&](std::int64_t& acc, std::int64_t index, const FP* A, const FP*, int n) {
+				const std::array<FP, 4> point = grid[index];
+				mismatch += !std::equal(point.begin(), point.end(), A);
+				acc += n == 3 ? index : 0;
+			},
+			[](std::int64_t& acc, const std::int64_t& other) { acc += other; }, tile_size);
+		if (sum != index_sum || mismatch != 0) {
+			throw std::runtime_error("Grid reduce mismatch.");
+		}
+	}
+}
+
+/* Test the C entry points forward to the solvers: the scalar entry 'c_scalar' to 'cubic_roots()' and the batch
+* entry 'c_batch' to 'cubic_roots_batch()' with 'cubic_roots_qbc()', results compared bitwise.
+*/
+template<typename FP>
+static void test_c_api(CBRT_SOLVER<FP> c_scalar, void (*c_batch)(const FP*, std::int64_t, FP*, int*),
+	std::int64_t N = 10000, int seed = 235201124) {
+	std::default_random_engine e1(seed);
+	std::uniform_real_distribution<FP> uniform_dist(-1.0, 1.0);
+	std::vector<FP> coeffs(4 * N);
+	for (FP& c : coeffs) {
+		c = uniform_dist(e1);
+	}
+	std::vector<FP> xroots(3 * N), xexpected(3 * N);
+	std::vector<int> nroots(N), nexpected(N);
+	c_batch(coeffs.data(), N, xroots.data(), nroots.data());
+	cubic_roots_batch<FP>(coeffs.data(), N, xexpected.data(), nexpected.data(), &cubic_roots_qbc<FP>);
+	if (nroots != nexpected || std::memcmp(xroots.data(), xexpected.data(), 3 * N * sizeof(FP)) != 0) {
+		throw std::runtime_error("C API batch mismatch.");
+	}
+	for (std::int64_t i = 0; i < N; i++) {
+		const FP* A = coeffs.data() + 4 * i;
+		FP x[3];
+		const int n = c_scalar(A[0], A[1], A[2], A[3], x);
+		if (n != cubic_roots<FP>(A[0], A[1], A[2], A[3], xexpected.data() + 3 * i)
+			|| std::memcmp(x, xexpected.data() + 3 * i, n * sizeof(FP)) != 0) {
+			throw std::runtime_error("C API scalar mismatch.");
+		}
+	}
+}
+
+/* Test the extended precision instantiations against roots known to the precision of FP.
+*/
+template<typename FP>
+static void test_extended() {
+	const FP tol = (FP)16.0 * fp_traits<FP>::epsilon;
+	FP x[3];
+	/* (x - 1)(x - 2)(x - 3), three real roots */
+	const FP exact[3] = { 3, 2, 1 };
+	CBRT_SOLVER<FP> solvers[2] = { &cubic_roots<FP>, &cubic_roots_qbc<FP> };
+	for (CBRT_SOLVER<FP> solver : solvers) {
+		if (solver((FP)1.0, (FP)-6.0, (FP)11.0, (FP)-6.0, x) != 3) {
+			throw std::runtime_error("Extended precision root count.");
+		}
+		for (int k = 0; k < 3; k++) {
+			bool found = false;
+			for (int j = 0; j < 3; j++) {
+				found = found || std::abs((double)(x[k] - exact[j])) <= (double)(tol * exact[j]);
+			}
+			if (!found) {
+				throw std::runtime_error("Extended precision root error.");
+			}
+		}
+	}
+	/* x^3 - 2, one real root (Cardano) equal to cbrt(2) = 2 / cbrt(2)^2 refined by a Newton step */
+	if (cubic_roots<FP>((FP)1.0, (FP)0.0, (FP)0.0, (FP)-2.0, x) != 1) {
+		throw std::runtime_error("Extended precision root count.");
+	}
+	FP r = x[0] - (x[0] * x[0] * x[0] - (FP)2.0) / ((FP)3.0 * x[0] * x[0]);
+	if (std::abs((double)(x[0] - r)) > (double)(tol * r)) {
+		throw std::runtime_error("Extended precision root error.");
+	}
+}
+
+/* Test 'cubic_roots_classified()' matches 'cubic_roots()' on a mix of random and degenerate equations.
+*/
+template<typename FP>
+static void test_classified(FP max, std::int64_t N = 100000, int seed = 235201124) {
+	std::default_random_engine e1(seed);
+	std::uniform_real_distribution<FP> uniform_dist(-max, max);
+	std::vector<FP> coeffs(4 * N);
+	for (FP& c : coeffs) {
+		c = uniform_dist(e1);
+	}
+	/* Degenerate lanes: a = 0, d = 0 and a triple root */
+	for (std::int64_t i = 0; i < N; i += 7) {
+		coeffs[4 * i + (i % 2 ? 0 : 3)] = 0;
+	}
+	const FP triple[4] = { 1, -3, 3, -1 };
+	std::copy(triple, triple + 4, coeffs.begin() + 4);
+
+	std::vector<FP> roots(3 * N);
+	std::vector<int> nroots(N);
+	cubic_roots_classified<FP>(coeffs.data(), N, roots.data(), nroots.data());
+	for (std::int64_t i = 0; i < N; i++) {
+		const FP* A = coeffs.data() + 4 * i;
+		FP cf[3];
+		int ncf = cubic_roots<FP>(A[0], A[1], A[2], A[3], cf);
+		assert_zero(ncf - nroots[i]);
+		for (int k = 0; k < ncf; k++) {
+			/* Clamped acos() argument: NaN roots from 'cubic_roots()' are replaced */
+			if (cf[k] == cf[k] && cf[k] != roots[3 * i + k]) {
+				throw std::runtime_error("Classified root mismatch.");
+			}
+		}
+	}
+}
+
+/* Test 'CubicService' results from concurrent producers (futures and callbacks) match 'cubic_roots_classified()'.
+*/
+template<typename FP>
+static void test_service(int nproducers = 4, std::int64_t N = 20000, int seed = 235201124) {
+	std::default_random_engine e1(seed);
+	std::uniform_real_distribution<FP> uniform_dist(-1.0, 1.0);
+	std::vector<FP> coeffs(4 * N);
+	for (FP& c : coeffs) {
+		c = uniform_dist(e1);
+	}
+	std::vector<FP> roots(3 * N);
+	std::vector<int> nroots(N);
+	cubic_roots_classified<FP>(coeffs.data(), N, roots.data(), nroots.data());
+
+	typename CubicService<FP>::Config config;
+	config.num_workers = 2;
+	config.max_batch = 32;
+	config.queue_capacity = 1024;
+	std::atomic<std::int64_t> nmismatch(0), ncallback(0);
+	auto verify = [&](std::int64_t i, const typename CubicService<FP>::Result& r) {
+		bool equal = r.n == nroots[i];
+		for (int k = 0; k < r.n; k++) {
+			equal = equal && r[k] == roots[3 * i + k];
+		}
+		nmismatch += !equal;
+	};
+	{
+		CubicService<FP> service(config);
+		std::vector<std::thread> producers;
+		for (int t = 0; t < nproducers; t++) {
+			producers.emplace_back([&, t]() {
+				/* Even producers wait on futures, odd producers use callbacks. */
+				for (std::int64_t i = t; i < N; i += nproducers) {
+					const FP* A = coeffs.data() + 4 * i;
+					if (t % 2 == 0) {
+						verify(i, service.submit(A[0], A[1], A[2], A[3]).get());
+					}
+					else {
+						service.submit(A[0], A[1], A[2], A[3], [&, i](const typename CubicService<FP>::Result& r) {
+							verify(i, r);
+							ncallback++;
+						});
+					}
+				}
+			});
+		}
+		for (std::thread& p : producers) {
+			p.join();
+		}
+		/* Destructor drains pending callbacks */
+	}
+	if (nmismatch > 0 || ncallback != N / 2) {
+		throw std::runtime_error("Solver service error.");
+	}
+}
+
+/* Verify eigenpairs of the symmetric matrix A satisfy A v = lambda v and form an orthonormal basis.
+*/
+template<typename FP>
+static void verify_eig3_sym(const FP* A, const FP* eval, const FP* evec, FP tol) {
+	const FP M[3][3] = { { A[0], A[1], A[2] }, { A[1], A[3], A[4] }, { A[2], A[4], A[5] } };
+	FP norm = 0.0;
+	for (int j = 0; j < 6; j++) {
+		norm = std::fmax(norm, std::abs(A[j]));
+	}
+	if (eval[0] > eval[1] || eval[1] > eval[2]) {
+		throw std::runtime_error("Eigenvalues not sorted.");
+	}
+	for (int k = 0; k < 3; k++) {
+		const FP* v = evec + 3 * k;
+		for (int j = 0; j < 3; j++) {
+			FP Av = M[j][0] * v[0] + M[j][1] * v[1] + M[j][2] * v[2];
+			if (std::abs(Av - eval[k] * v[j]) > tol * norm) {
+				throw std::runtime_error("Eigenpair residual exceeds tolerance.");
+			}
+		}
+		for (int l = 0; l < 3; l++) {
+			FP d = v[0] * evec[3 * l] + v[1] * evec[3 * l + 1] + v[2] * evec[3 * l + 2];
+			if (std::abs(d - (k == l ? 1.0 : 0.0)) > tol) {
+				throw std::runtime_error("Eigenvectors not orthonormal.");
+			}
+		}
+	}
+}
+
+/* Test 'eig3_sym()' and 'eig3_sym_batch()' on random and degenerate symmetric matrices.
+*/
+template<typename FP, bool FAST = false>
+static void test_eig3_sym(FP tol, std::int64_t N = 10000, int seed = 235201124) {
+	std::default_random_engine e1(seed);
+	std::uniform_real_distribution<FP> uniform_dist(-1.0, 1.0);
+	std::vector<FP> A(6 * N);
+	for (FP& a : A) {
+		a = uniform_dist(e1);
+	}
+	/* Degenerate cases: zero, scaled identity, double eigenvalues and entries close to overflow. */
+	const FP big = std::numeric_limits<FP>::max() / (FP)4.0;
+	const FP cases[][6] = {
+		{ 0, 0, 0, 0, 0, 0 },
+		{ 5, 0, 0, 5, 0, 0 },
+		{ 1, 0, 0, 1, 0, 2 },
+		{ 2, 1, 1, 2, 1, 2 },
+		{ big, 0, 0, -big, 0, big / (FP)2.0 },
+		{ big, big, 0, big, 0, -big },
+	};
+	for (int c = 0; c < 6; c++) {
+		for (int j = 0; j < 6; j++) {
+			A[6 * c + j] = cases[c][j];
+		}
+	}
+
+	std::vector<FP> eval(3 * N), evec(9 * N);
+	for (std::int64_t i = 0; i < N; i++) {
+		eig3_sym<FP, FAST>(A.data() + 6 * i, eval.data() + 3 * i, evec.data() + 9 * i);
+		verify_eig3_sym<FP>(A.data() + 6 * i, eval.data() + 3 * i, evec.data() + 9 * i, tol);
+	}
+
+	/* Batch (SoA) results match the scalar function */
+	std::vector<FP> soa(6 * N), beval(3 * N), bevec(9 * N);
+	for (std::int64_t i = 0; i < N; i++) {
+		for (int j = 0; j < 6; j++) {
+			soa[j * N + i] = A[6 * i + j];
+		}
+	}
+	eig3_sym_batch<FP, FAST>(soa.data(), N, beval.data(), bevec.data());
+	for (std::int64_t i = 0; i < N; i++) {
+		for (int k = 0; k < 3; k++) {
+			assert_zero(beval[k * N + i] - eval[3 * i + k]);
+		}
+		for (int j = 0; j < 9; j++) {
+			assert_zero(bevec[j * N + i] - evec[9 * i + j]);
+		}
+	}
+}
+
+/* Test 'eig3()' and 'eig3_batch()' on random and degenerate general matrices by comparing the invariants
+ * (trace, sum of principal minors, determinant) computed from the eigenvalues with those of the matrix.
+*/
+template<typename FP>
+static void test_eig3(FP tol, std::int64_t N = 10000, int seed = 235201124) {
+	typedef std::complex<FP> C;
+	std::default_random_engine e1(seed);
+	std::uniform_real_distribution<FP> uniform_dist(-1.0, 1.0);
+	std::vector<FP> A(9 * N);
+	for (FP& a : A) {
+		a = uniform_dist(e1);
+	}
+	/* Degenerate cases: zero, scaled identity, rotation (complex pair on the unit circle) and a Jordan block. */
+	const FP cases[][9] = {
+		{ 0, 0, 0, 0, 0, 0, 0, 0, 0 },
+		{ 3, 0, 0, 0, 3, 0, 0, 0, 3 },
+		{ 0, -1, 0, 1, 0, 0, 0, 0, 1 },
+		{ 2, 1, 0, 0, 2, 1, 0, 0, 2 },
+	};
+	for (int c = 0; c < 4; c++) {
+		for (int j = 0; j < 9; j++) {
+			A[9 * c + j] = cases[c][j];
+		}
+	}
+
+	std::vector<FP> re(3 * N), im(3 * N);
+	for (std::int64_t i = 0; i < N; i++) {
+		const FP* M = A.data() + 9 * i;
+		FP* r = re.data() + 3 * i;
+		FP* c = im.data() + 3 * i;
+		int n = eig3<FP>(M, r, c);
+		if ((n == 3) != (c[1] == 0 && c[2] == 0) || c[1] != -c[2] || c[1] < 0) {
+			throw std::runtime_error("Complex eigenvalues not ordered as conjugate pair.");
+		}
+		if (n == 3 && (r[0] < r[1] || r[1] < r[2])) {
+			throw std::runtime_error("Real eigenvalues not ordered descending.");
+		}
+		C l0(r[0], c[0]), l1(r[1], c[1]), l2(r[2], c[2]);
+		FP trace = M[0] + M[4] + M[8];
+		FP minors = (M[0] * M[4] - M[1] * M[3]) + (M[0] * M[8] - M[2] * M[6]) + (M[4] * M[8] - M[5] * M[7]);
+		FP det = M[0] * (M[4] * M[8] - M[5] * M[7]) - M[1] * (M[3] * M[8] - M[5] * M[6]) + M[2] * (M[3] * M[7] - M[4] * M[6]);
+		FP norm = 1.0;
+		for (int j = 0; j < 9; j++) {
+			norm = std::fmax(norm, std::abs(M[j]));
+		}
+		if (std::abs(l0 + l1 + l2 - trace) > tol * norm
+			|| std::abs(l0 * l1 + l0 * l2 + l1 * l2 - minors) > tol * norm * norm
+			|| std::abs(l0 * l1 * l2 - det) > tol * norm * norm * norm) {
+			throw std::runtime_error("Eigenvalue invariants exceed tolerance.");
+		}
+	}
+	/* Rotation: 1, +-i */
+	assert_zero<FP>(re[6] - (FP)1.0);
+	assert_zero<FP>(im[7] - (FP)1.0);
+
+	/* Batch (SoA) results match the scalar function */
+	std::vector<FP> soa(9 * N), bre(3 * N), bim(3 * N);
+	for (std::int64_t i = 0; i < N; i++) {
+		for (int j = 0; j < 9; j++) {
+			soa[j * N + i] = A[9 * i + j];
+		}
+	}
+	eig3_batch<FP>(soa.data(), N, bre.data(), bim.data());
+	for (std::int64_t i = 0; i < N; i++) {
+		for (int k = 0; k < 3; k++) {
+			assert_zero(bre[k * N + i] - re[3 * i + k]);
+			assert_zero(bim[k * N + i] - im[3 * i + k]);
+		}
+	}
+
+	/* A double eigenvalue larger than the single one (may be split into a tiny complex pair by rounding). */
+	const FP D[9] = { 0.5, 0, 0, 0, -1, 0, 0, 0, 0.5 };
+	FP r[3], c[3];
+	if (eig3<FP>(D, r, c) == 3 && (r[0] < r[1] || r[1] < r[2])) {
+		throw std::runtime_error("Real eigenvalues not ordered descending.");
+	}
+
+	/* Subnormal matrices: the scale is clamped rather than overflowing 1 / scale. */
+	const FP tiny = std::numeric_limits<FP>::min() / 16;
+	const FP S[9] = { 3 * tiny, 0, 0, 0, 2 * tiny, 0, 0, 0, tiny };
+	const FP Ssym[6] = { 3 * tiny, 0, 0, 2 * tiny, 0, tiny };
+	FP sym[3];
+	eig3<FP>(S, r, c);
+	eig3_sym<FP>(Ssym, sym);
+	for (int k = 0; k < 3; k++) {
+		if (!(std::abs(r[k] - (3 - k) * tiny) <= tol * tiny) || !(std::abs(sym[k] - (k + 1) * tiny) <= tol * tiny)) {
+			throw std::runtime_error("Eigenvalues of a subnormal matrix not finite.");
+		}
+	}
+}
 
 template<typename FP>
 static void timing_test_instance(CBRT_SOLVER<FP> cbrt_solver, std::size_t N, int seed)
@@ -160,8 +1006,71 @@ int main(void) {
 	testcases(&cubic_roots_qbc<double>);
 	testcases(&cubic_roots<double>);
 
+	test_cubic_csr(&cubic_roots<double>);
+	test_cubic_csr(&cubic_roots_qbc<double>);
+	test_cubic_csr(&cubic_roots<float>);
+
+	test_constexpr<double>();
+	test_constexpr<float>();
+
+	test_monic_depressed<double>();
+	test_monic_depressed<float>();
+
+	test_fast_math<double>(2, 2, 1);
+	test_fast_math<float>(2, 3, 1);
+	test_fast_accuracy<double>(1e0);
+	test_fast_accuracy<double>(1e5);
+	test_fast_accuracy<float>(1e0);
+
+	test_hybrid<double>(1e0);
+	test_hybrid<double>(1e5);
+	test_hybrid<float>(1e0);
+	test_poly_eval<double>();
+	test_poly_eval<float>();
+	test_refined();
+	test_aligned_buffer();
+	test_ndgrid<double, 2>({ 7, 5 });
+	test_ndgrid<double, 3>({ 9, 1, 300 });
+	test_ndgrid<float, 3>({ 1, 200, 3 });
+	test_ndgrid<float, 4>({ 3, 4, 5, 6 });
+	test_ndgrid<double, 3>({ 40, 30, 21 });
+	test_cubic_roots_grid<double>();
+	test_cubic_roots_grid<float>();
+	test_grid_reduce<double>();
+	test_grid_reduce<float>();
+	test_c_api<double>(&cubic_roots_d, &cubic_roots_qbc_batch_d);
+	test_c_api<float>(&cubic_roots_f, &cubic_roots_qbc_batch_f);
+	test_qbc_bounded<double>(1e0);
+	test_qbc_bounded<double>(1e5);
+	test_qbc_bounded<float>(1e0);
+	test_extended<double>();
+	test_extended<long double>();
+#ifdef CUBIC_FLOAT128
+	test_extended<__float128>();
+#endif
+	test_classified<double>(1e0);
+	test_classified<double>(1e5);
+	test_classified<float>(1e0);
+	test_service<double>();
+	test_service<float>();
+
+	test_eig3_sym<double>(1e-7);
+	test_eig3_sym<float>(1e-3f);
+	test_eig3_sym<double, true>(1e-7);
+	test_eig3_sym<float, true>(1e-3f);
+	test_eig3<double>(1e-12);
+	test_eig3<float>(1e-4f);
+
+	run_accuracy_test(&cubic_roots<double>, "cubic", 1e0);
+	run_accuracy_test(&cubic_roots_fast<double>, "fast", 1e0);
+	run_accuracy_test(&cubic_roots_qbc<double>, "qbc", 1e0);
+	run_accuracy_test(&cubic_roots<double>, "cubic", 1e5);
+	run_accuracy_test(&cubic_roots_fast<double>, "fast", 1e5);
+	run_accuracy_test(&cubic_roots_qbc<double>, "qbc", 1e5);
+
 	run_timing_test(&cubic_roots<double>, "cubic");
 	run_timing_test(&cubic_roots_qbc<double>, "qbc");
+	run_timing_test(&cubic_roots_fast<double>, "fast");
 
 	return 0;
 
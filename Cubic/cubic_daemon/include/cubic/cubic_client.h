@@ -0,0 +1,69 @@
+#pragma once
+/* Client for the cubic solver daemon (POSIX only).
+*
+*	CubicClient client;
+*	SharedBatch<double> batch(N);
+*	// fill batch.coeffs()[4 * i ...]
+*	std::int64_t total = client.solve(batch);
+*	// read batch.xroots(), batch.nroots()
+*
+* Provided under the Unlicense License (public domain, see license terms at http://unlicense.org/).
+*/
+#include<cstdint>
+#include<string>
+
+
+/**
+ * Batch of N equations in a POSIX shared memory segment, the daemon reads the coefficients from and writes the
+ * results to the segment (no copies through the socket). Layout is described in 'cubic_protocol.h'. Throws
+ * std::runtime_error on failure.
+ */
+template<typename FP>
+class SharedBatch {
+public:
+	explicit SharedBatch(std::int64_t N);
+	~SharedBatch();
+
+	SharedBatch(const SharedBatch&) = delete;
+	SharedBatch& operator=(const SharedBatch&) = delete;
+
+	std::int64_t size() const { return m_N; }
+	const std::string& name() const { return m_name; }
+
+	/* Coefficients stored row-wise as [a_i, b_i, c_i, d_i]. */
+	FP* coeffs() { return m_coeffs; }
+	/* Roots of the i:th equation in xroots()[3 * i] ... xroots()[3 * i + nroots()[i] - 1]. */
+	const FP* xroots() const { return m_xroots; }
+	const std::int32_t* nroots() const { return m_nroots; }
+
+private:
+	std::int64_t m_N;
+	std::string m_name;
+	void* m_data;
+	std::size_t m_bytes;
+	FP* m_coeffs;
+	FP* m_xroots;
+	std::int32_t* m_nroots;
+};
+
+/**
+ * Connection to the solver daemon. The socket path defaults to $CUBIC_SOCKET or '/tmp/cubic_solver.sock'.
+ * Throws std::runtime_error if the daemon is unreachable or a job fails.
+ */
+class CubicClient {
+public:
+	explicit CubicClient(const std::string& socket_path = "");
+	~CubicClient();
+
+	CubicClient(const CubicClient&) = delete;
+	CubicClient& operator=(const CubicClient&) = delete;
+
+	/**
+	 * Solve the batch in place, blocking until the daemon replies. Returns the total number of real roots.
+	 */
+	template<typename FP>
+	std::int64_t solve(SharedBatch<FP>& batch);
+
+private:
+	int m_socket;
+};
@@ -0,0 +1,125 @@
+#pragma once
+/* Wire protocol of the cubic solver daemon, shared by the daemon and its clients.
+*
+* A job is a POSIX shared memory segment created by the client holding, for N equations of the given dtype:
+*
+*	offset 0				coeffs[4 * N]	(row-wise [a_i, b_i, c_i, d_i])
+*	offset 4 * N * sizeof(FP)		xroots[3 * N]	(padded roots, as 'cubic_roots_batch()')
+*	offset 7 * N * sizeof(FP)		nroots[N]	(int32)
+*
+* The client sends a JobRequest naming the segment over the Unix domain (stream) socket, the daemon maps the
+* segment, copies the coefficients, solves the batch and writes the roots back before answering with a JobReply.
+* A segment truncated by the client during the job fails only that job (SHM_ERROR). Messages are fixed size, in host byte order
+* (both ends share the host) and a connection may carry any number of jobs.
+*
+* Provided under the Unlicense License (public domain, see license terms at http://unlicense.org/).
+*/
+#include<cerrno>
+#include<cstddef>
+#include<cstdint>
+
+#include<sys/socket.h>
+#include<sys/types.h>
+
+
+namespace cubic_protocol {
+
+	constexpr std::uint32_t MAGIC = 0x43554243; /* "CUBC" */
+	constexpr const char* DEFAULT_SOCKET = "/tmp/cubic_solver.sock";
+	/* Environment variable overriding the default socket path. */
+	constexpr const char* SOCKET_ENV = "CUBIC_SOCKET";
+	constexpr std::size_t SHM_NAME_SIZE = 64;
+
+	enum DType : std::uint32_t {
+		FLOAT64 = 0,
+		FLOAT32 = 1,
+	};
+
+	enum Status : std::int32_t {
+		OK = 0,
+		BAD_REQUEST = 1,
+		SHM_ERROR = 2,
+		OUT_OF_MEMORY = 3,
+	};
+
+	struct JobRequest {
+		std::uint32_t magic;
+		std::uint32_t dtype;
+		std::int64_t N;
+		/* Null terminated shared memory name, e.g. "/cubic_1234_0". */
+		char shm_name[SHM_NAME_SIZE];
+	};
+
+	struct JobReply {
+		std::int32_t status;
+		std::int32_t reserved;
+		/* Total number of real roots. */
+		std::int64_t nroots;
+	};
+
+	/* Size in bytes of a coefficient or root of the dtype. */
+	inline std::size_t fp_size(std::uint32_t dtype)
+	{
+		return dtype == FLOAT32 ? sizeof(float) : sizeof(double);
+	}
+
+	/**
+	 * Size in bytes of one equation (coefficients, roots and root count) of a job segment.
+	 */
+	inline std::size_t equation_size(std::uint32_t dtype)
+	{
+		return 7 * fp_size(dtype) + sizeof(std::int32_t);
+	}
+
+	/**
+	 * Largest number of equations a segment of 'bytes' bytes holds, N is valid for a segment if 0 <= N <=
+	 * max_equations(dtype, bytes). Use max_equations(dtype, SIZE_MAX) to bound N before computing 'segment_size()'.
+	 */
+	inline std::int64_t max_equations(std::uint32_t dtype, std::size_t bytes)
+	{
+		const std::size_t n = bytes / equation_size(dtype);
+		return n > (std::size_t)INT64_MAX ? INT64_MAX : (std::int64_t)n;
+	}
+
+	/**
+	 * Size in bytes of a job segment holding N equations, N must not exceed max_equations(dtype, SIZE_MAX).
+	 */
+	inline std::size_t segment_size(std::uint32_t dtype, std::int64_t N)
+	{
+		return (std::size_t)N * equation_size(dtype);
+	}
+
+	/* Send / receive exactly n bytes over the socket, retrying partial transfers and interrupts. */
+	inline bool send_all(int fd, const void* buf, std::size_t n)
+	{
+		const char* p = (const char*)buf;
+		while (n > 0) {
+			ssize_t k = send(fd, p, n, MSG_NOSIGNAL);
+			if (k < 0 && errno == EINTR) {
+				continue;
+			}
+			if (k <= 0) {
+				return false;
+			}
+			p += k;
+			n -= (std::size_t)k;
+		}
+		return true;
+	}
+	inline bool recv_all(int fd, void* buf, std::size_t n)
+	{
+		char* p = (char*)buf;
+		while (n > 0) {
+			ssize_t k = recv(fd, p, n, 0);
+			if (k < 0 && errno == EINTR) {
+				continue;
+			}
+			if (k <= 0) {
+				return false;
+			}
+			p += k;
+			n -= (std::size_t)k;
+		}
+		return true;
+	}
+}
@@ -0,0 +1,108 @@
+"""
+Python client for the cubic solver daemon, see 'cubic_protocol.h' for the wire protocol and segment layout.
+
+    with CubicClient() as client, SharedBatch(N, np.float64) as batch:
+        batch.coeffs[:] = A          # (N, 4) array of [a, b, c, d] rows
+        total = client.solve(batch)
+        roots, nroots = batch.xroots, batch.nroots
+"""
+import os
+import socket
+import struct
+from multiprocessing import shared_memory
+import numpy as np
+
+MAGIC = 0x43554243
+DEFAULT_SOCKET = "/tmp/cubic_solver.sock"
+SOCKET_ENV = "CUBIC_SOCKET"
+SHM_NAME_SIZE = 64
+DTYPES = {np.dtype(np.float64): 0, np.dtype(np.float32): 1}
+STATUS = {0: "OK", 1: "BAD_REQUEST", 2: "SHM_ERROR", 3: "OUT_OF_MEMORY"}
+
+# struct JobRequest / JobReply (host byte order)
+_REQUEST = struct.Struct("=IIq%ds" % SHM_NAME_SIZE)
+_REPLY = struct.Struct("=iiq")
+
+
+class SharedBatch:
+    """
+    Batch of N equations in a POSIX shared memory segment solved by the daemon, which copies the
+    coefficients out of and the roots into the segment.
+
+    Attributes coeffs (N, 4), xroots (N, 3) and nroots (N,) are numpy views of the segment.
+    """
+
+    def __init__(self, N, dtype=np.float64):
+        dtype = np.dtype(dtype)
+        if dtype not in DTYPES:
+            raise TypeError("Unsupported dtype %s, expected float64 or float32." % dtype)
+        self.N = N
+        self.dtype = dtype
+        nbytes = N * (7 * dtype.itemsize + 4)
+        self._shm = shared_memory.SharedMemory(create=True, size=max(nbytes, 1))
+        fp = N * dtype.itemsize
+        self.coeffs = np.ndarray((N, 4), dtype=dtype, buffer=self._shm.buf, offset=0)
+        self.xroots = np.ndarray((N, 3), dtype=dtype, buffer=self._shm.buf, offset=4 * fp)
+        self.nroots = np.ndarray((N,), dtype=np.int32, buffer=self._shm.buf, offset=7 * fp)
+
+    @property
+    def name(self):
+        """ POSIX name of the segment. """
+        return "/" + self._shm.name.lstrip("/")
+
+    def roots(self, i):
+        """ Real roots of the i:th equation. """
+        return self.xroots[i, :self.nroots[i]]
+
+    def close(self):
+        if self._shm is not None:
+            self.coeffs = self.xroots = self.nroots = None
+            self._shm.close()
+            self._shm.unlink()
+            self._shm = None
+
+    def __enter__(self):
+        return self
+
+    def __exit__(self, *args):
+        self.close()
+
+
+class CubicClient:
+    """
+    Connection to the solver daemon, socket path defaults to $CUBIC_SOCKET or '/tmp/cubic_solver.sock'.
+    """
+
+    def __init__(self, socket_path=None):
+        if socket_path is None:
+            socket_path = os.environ.get(SOCKET_ENV, DEFAULT_SOCKET)
+        self._sock = socket.socket(socket.AF_UNIX, socket.SOCK_STREAM)
+        self._sock.connect(socket_path)
+
+    def solve(self, batch):
+        """
+        Solve the batch in place, blocking until the daemon replies. Returns the total number of real roots.
+        """
+        name = batch.name.encode()
+        if len(name) >= SHM_NAME_SIZE:
+            raise ValueError("Shared memory name too long.")
+        self._sock.sendall(_REQUEST.pack(MAGIC, DTYPES[batch.dtype], batch.N, name))
+        data = b""
+        while len(data) < _REPLY.size:
+            chunk = self._sock.recv(_REPLY.size - len(data))
+            if not chunk:
+                raise ConnectionError("Connection to cubic daemon lost.")
+            data += chunk
+        status, _, nroots = _REPLY.unpack(data)
+        if status != 0:
+            raise RuntimeError("Cubic daemon job failed: %s" % STATUS.get(status, status))
+        return nroots
+
+    def close(self):
+        self._sock.close()
+
+    def __enter__(self):
+        return self
+
+    def __exit__(self, *args):
+        self.close()
@@ -0,0 +1,123 @@
+/* Client for the cubic solver daemon (POSIX only).
+*
+* Provided under the Unlicense License (public domain, see license terms at http://unlicense.org/).
+*/
+#include "cubic/cubic_client.h"
+#include "cubic/cubic_protocol.h"
+
+#include<atomic>
+#include<cerrno>
+#include<cstdlib>
+#include<cstring>
+#include<stdexcept>
+#include<type_traits>
+
+#include<fcntl.h>
+#include<sys/mman.h>
+#include<sys/socket.h>
+#include<sys/un.h>
+#include<unistd.h>
+
+
+namespace {
+
+	/* Per process segment counter, names are '/cubic_<pid>_<counter>'. */
+	std::atomic<int> segment_counter(0);
+
+	template<typename FP>
+	constexpr std::uint32_t dtype()
+	{
+		return std::is_same<float, FP>::value ? cubic_protocol::FLOAT32 : cubic_protocol::FLOAT64;
+	}
+}
+
+
+template<typename FP>
+SharedBatch<FP>::SharedBatch(std::int64_t N)
+	: m_N(N), m_data(nullptr), m_bytes(0)
+{
+	if (N < 0 || N > cubic_protocol::max_equations(dtype<FP>(), SIZE_MAX)) {
+		throw std::runtime_error("Invalid batch size " + std::to_string(N) + ".");
+	}
+	m_bytes = cubic_protocol::segment_size(dtype<FP>(), N);
+	m_name = "/cubic_" + std::to_string(getpid()) + "_" + std::to_string(segment_counter++);
+
+	int fd = shm_open(m_name.c_str(), O_CREAT | O_EXCL | O_RDWR, 0600);
+	if (fd < 0) {
+		throw std::runtime_error("shm_open() failed: " + std::string(std::strerror(errno)));
+	}
+	/* mmap() of a zero sized segment fails, keep at least one page. */
+	const std::size_t bytes = m_bytes > 0 ? m_bytes : 1;
+	if (ftruncate(fd, (off_t)bytes) != 0
+		|| (m_data = mmap(nullptr, bytes, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0)) == MAP_FAILED) {
+		const std::string err = std::strerror(errno);
+		close(fd);
+		shm_unlink(m_name.c_str());
+		throw std::runtime_error("Shared memory allocation failed: " + err);
+	}
+	close(fd);
+	m_coeffs = (FP*)m_data;
+	m_xroots = m_coeffs + 4 * N;
+	m_nroots = (std::int32_t*)(m_xroots + 3 * N);
+}
+
+template<typename FP>
+SharedBatch<FP>::~SharedBatch()
+{
+	munmap(m_data, m_bytes > 0 ? m_bytes : 1);
+	shm_unlink(m_name.c_str());
+}
+template class SharedBatch<double>;
+template class SharedBatch<float>;
+
+
+CubicClient::CubicClient(const std::string& socket_path)
+{
+	std::string path = socket_path;
+	if (path.empty()) {
+		const char* env = std::getenv(cubic_protocol::SOCKET_ENV);
+		path = env ? env : cubic_protocol::DEFAULT_SOCKET;
+	}
+	sockaddr_un addr = {};
+	addr.sun_family = AF_UNIX;
+	if (path.size() >= sizeof(addr.sun_path)) {
+		throw std::runtime_error("Socket path too long: " + path);
+	}
+	std::strcpy(addr.sun_path, path.c_str());
+
+	m_socket = socket(AF_UNIX, SOCK_STREAM, 0);
+	if (m_socket < 0 || connect(m_socket, (const sockaddr*)&addr, sizeof(addr)) != 0) {
+		const std::string err = std::strerror(errno);
+		if (m_socket >= 0) {
+			close(m_socket);
+		}
+		throw std::runtime_error("Unable to connect to cubic daemon at " + path + ": " + err);
+	}
+}
+
+CubicClient::~CubicClient()
+{
+	close(m_socket);
+}
+
+template<typename FP>
+std::int64_t CubicClient::solve(SharedBatch<FP>& batch)
+{
+	cubic_protocol::JobRequest request = {};
+	request.magic = cubic_protocol::MAGIC;
+	request.dtype = dtype<FP>();
+	request.N = batch.size();
+	std::strncpy(request.shm_name, batch.name().c_str(), cubic_protocol::SHM_NAME_SIZE - 1);
+
+	cubic_protocol::JobReply reply;
+	if (!cubic_protocol::send_all(m_socket, &request, sizeof(request))
+		|| !cubic_protocol::recv_all(m_socket, &reply, sizeof(reply))) {
+		throw std::runtime_error("Connection to cubic daemon lost.");
+	}
+	if (reply.status != cubic_protocol::OK) {
+		throw std::runtime_error("Cubic daemon job failed with status " + std::to_string(reply.status) + ".");
+	}
+	return reply.nroots;
+}
+template std::int64_t CubicClient::solve(SharedBatch<double>& batch);
+template std::int64_t CubicClient::solve(SharedBatch<float>& batch);
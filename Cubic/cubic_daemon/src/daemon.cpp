@@ -0,0 +1,222 @@
+/* Cubic solver daemon: solves batch jobs from local processes over a Unix domain socket, with coefficients and
+* roots exchanged through POSIX shared memory (see 'cubic_protocol.h').
+*
+* Usage: cubic_daemon [socket_path]
+*
+* Each client connection is served by a lightweight thread, jobs from all clients are solved one at a time by a
+* single OpenMP thread team shared by all clients. Threads are spread over the available places and each thread
+* solves the same contiguous chunk of every job, run with e.g. OMP_PLACES=cores OMP_PROC_BIND=spread to keep the
+* team distributed over NUMA nodes.
+*
+* Coefficients are copied out of the client segment before solving and the roots copied back after, the team only
+* touches daemon owned memory. A client truncating its segment during a job makes the copy fault (SIGBUS), the
+* fault is caught in the copying thread and only that job fails.
+*
+* Provided under the Unlicense License (public domain, see license terms at http://unlicense.org/).
+*/
+#include "cubic/cubic.h"
+#include "cubic/cubic_protocol.h"
+
+#include<atomic>
+#include<cerrno>
+#include<csetjmp>
+#include<csignal>
+#include<cstdint>
+#include<cstdio>
+#include<cstdlib>
+#include<cstring>
+#include<mutex>
+#include<new>
+#include<string>
+#include<thread>
+#include<vector>
+
+#include<fcntl.h>
+#include<sys/mman.h>
+#include<sys/socket.h>
+#include<sys/stat.h>
+#include<sys/un.h>
+#include<unistd.h>
+
+
+namespace {
+
+	/* Serializes jobs onto the shared OpenMP team. */
+	std::mutex pool_mutex;
+
+	/* Set while the serving thread copies from / to a client segment, see 'on_sigbus()'. */
+	thread_local sigjmp_buf* volatile segment_fault = nullptr;
+
+	/* Accesses past the end of a segment truncated by its client raise SIGBUS in the accessing thread. */
+	void on_sigbus(int sig)
+	{
+		if (segment_fault) {
+			siglongjmp(*segment_fault, 1);
+		}
+		std::signal(sig, SIG_DFL);
+		std::raise(sig);
+	}
+
+	/* Copy n bytes from / to a mapped client segment, returns false if the segment was truncated. */
+	bool segment_copy(void* dst, const void* src, std::size_t n)
+	{
+		sigjmp_buf env;
+		if (sigsetjmp(env, 1) != 0) {
+			segment_fault = nullptr;
+			return false;
+		}
+		/* Fences keep the copy between the stores, which the compiler otherwise sees as dead. */
+		segment_fault = &env;
+		std::atomic_signal_fence(std::memory_order_seq_cst);
+		std::memcpy(dst, src, n);
+		std::atomic_signal_fence(std::memory_order_seq_cst);
+		segment_fault = nullptr;
+		return true;
+	}
+
+	/**
+	* Solve the job in place in the daemon owned copy of the segment, threads are spread over the places and
+	* assigned static contiguous chunks.
+	*/
+	template<typename FP>
+	std::int64_t solve(void* data, std::int64_t N)
+	{
+		const FP* coeffs = (const FP*)data;
+		FP* xroots = (FP*)data + 4 * N;
+		std::int32_t* nroots = (std::int32_t*)(xroots + 3 * N);
+		std::int64_t total = 0;
+#pragma omp parallel for proc_bind(spread) schedule(static) reduction(+:total)
+		for (std::int64_t i = 0; i < N; i++) {
+			const FP* A = coeffs + 4 * i;
+			nroots[i] = cubic_roots<FP>(A[0], A[1], A[2], A[3], xroots + 3 * i);
+			total += nroots[i];
+		}
+		return total;
+	}
+
+	cubic_protocol::JobReply run_job(const cubic_protocol::JobRequest& request)
+	{
+		cubic_protocol::JobReply reply = { cubic_protocol::OK, 0, 0 };
+		if (request.magic != cubic_protocol::MAGIC
+			|| (request.dtype != cubic_protocol::FLOAT64 && request.dtype != cubic_protocol::FLOAT32)
+			|| request.N < 0 || request.N > cubic_protocol::max_equations(request.dtype, SIZE_MAX)
+			|| std::memchr(request.shm_name, 0, cubic_protocol::SHM_NAME_SIZE) == nullptr) {
+			reply.status = cubic_protocol::BAD_REQUEST;
+			return reply;
+		}
+		if (request.N == 0) {
+			return reply;
+		}
+
+		/* Map the client segment, verifying it holds the full job. */
+		const std::size_t bytes = cubic_protocol::segment_size(request.dtype, request.N);
+		int fd = shm_open(request.shm_name, O_RDWR, 0);
+		struct stat st;
+		void* data = MAP_FAILED;
+		if (fd >= 0 && fstat(fd, &st) == 0 && st.st_size >= 0
+			&& request.N <= cubic_protocol::max_equations(request.dtype, (std::size_t)st.st_size)) {
+			data = mmap(nullptr, bytes, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+		}
+		if (fd >= 0) {
+			close(fd);
+		}
+		if (data == MAP_FAILED) {
+			reply.status = cubic_protocol::SHM_ERROR;
+			return reply;
+		}
+
+		/* The segment may still be truncated after the size check, it is only accessed by 'segment_copy()'. */
+		std::vector<double> job;
+		try {
+			job.resize((bytes + sizeof(double) - 1) / sizeof(double));
+		}
+		catch (const std::bad_alloc&) {
+			munmap(data, bytes);
+			reply.status = cubic_protocol::OUT_OF_MEMORY;
+			return reply;
+		}
+		const std::size_t coeff_bytes = 4 * (std::size_t)request.N * cubic_protocol::fp_size(request.dtype);
+		if (!segment_copy(job.data(), data, coeff_bytes)) {
+			munmap(data, bytes);
+			reply.status = cubic_protocol::SHM_ERROR;
+			return reply;
+		}
+		{
+			std::lock_guard<std::mutex> lock(pool_mutex);
+			reply.nroots = request.dtype == cubic_protocol::FLOAT32 ?
+				solve<float>(job.data(), request.N) : solve<double>(job.data(), request.N);
+		}
+		if (!segment_copy((char*)data + coeff_bytes, (const char*)job.data() + coeff_bytes, bytes - coeff_bytes)) {
+			reply.status = cubic_protocol::SHM_ERROR;
+			reply.nroots = 0;
+		}
+		munmap(data, bytes);
+		return reply;
+	}
+
+	void serve(int client)
+	{
+		cubic_protocol::JobRequest request;
+		while (cubic_protocol::recv_all(client, &request, sizeof(request))) {
+			cubic_protocol::JobReply reply = run_job(request);
+			if (!cubic_protocol::send_all(client, &reply, sizeof(reply))) {
+				break;
+			}
+		}
+		close(client);
+	}
+}
+
+
+int main(int argc, char* argv[])
+{
+	std::string path = argc > 1 ? argv[1] : "";
+	if (path.empty()) {
+		const char* env = std::getenv(cubic_protocol::SOCKET_ENV);
+		path = env ? env : cubic_protocol::DEFAULT_SOCKET;
+	}
+	sockaddr_un addr = {};
+	addr.sun_family = AF_UNIX;
+	if (path.size() >= sizeof(addr.sun_path)) {
+		std::fprintf(stderr, "Socket path too long: %s\n", path.c_str());
+		return 1;
+	}
+	std::strcpy(addr.sun_path, path.c_str());
+	std::signal(SIGPIPE, SIG_IGN);
+	struct sigaction bus = {};
+	bus.sa_handler = on_sigbus;
+	sigemptyset(&bus.sa_mask);
+	sigaction(SIGBUS, &bus, nullptr);
+
+	/* Replace a stale socket left by a previous daemon, never any other file. */
+	struct stat st;
+	if (lstat(path.c_str(), &st) == 0) {
+		if (!S_ISSOCK(st.st_mode)) {
+			std::fprintf(stderr, "Refusing to replace %s: not a socket\n", path.c_str());
+			return 1;
+		}
+		unlink(path.c_str());
+	}
+	int server = socket(AF_UNIX, SOCK_STREAM, 0);
+	if (server < 0 || bind(server, (const sockaddr*)&addr, sizeof(addr)) != 0 || listen(server, SOMAXCONN) != 0) {
+		std::fprintf(stderr, "Unable to listen on %s: %s\n", path.c_str(), std::strerror(errno));
+		return 1;
+	}
+	std::printf("cubic_daemon listening on %s\n", path.c_str());
+	std::fflush(stdout);
+
+	for (;;) {
+		int client = accept(server, nullptr, nullptr);
+		if (client < 0) {
+			if (errno == EINTR) {
+				continue;
+			}
+			std::fprintf(stderr, "accept() failed: %s\n", std::strerror(errno));
+			break;
+		}
+		std::thread(serve, client).detach();
+	}
+	close(server);
+	unlink(path.c_str());
+	return 1;
+}
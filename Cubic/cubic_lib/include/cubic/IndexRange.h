@@ -0,0 +1,68 @@
+#pragma once
+/* Contiguous range of point / equation indices [start, start + size).
+*
+* Provided under the Unlicense License (public domain, see license terms at http://unlicense.org/).
+*/
+#include<assert.h>
+#include<cstdint>
+
+
+class IndexRange {
+public:
+	constexpr IndexRange() = default;
+
+	/* Range [0, size). */
+	constexpr explicit IndexRange(std::int64_t size) : m_start(0), m_size(size)
+	{
+		assert(size >= 0);
+	}
+
+	/* Range [start, start + size). */
+	constexpr IndexRange(std::int64_t start, std::int64_t size) : m_start(start), m_size(size)
+	{
+		assert(start >= 0 && size >= 0);
+	}
+
+	/* First index, undefined for an empty range. */
+	constexpr std::int64_t start() const { return m_start; }
+	/* Number of indices in the range. */
+	constexpr std::int64_t size() const { return m_size; }
+	/* Index one past the last. */
+	constexpr std::int64_t one_after_last() const { return m_start + m_size; }
+
+	/* The i:th index of the range. */
+	constexpr std::int64_t operator[](std::int64_t i) const
+	{
+		assert(i >= 0 && i < m_size);
+		return m_start + i;
+	}
+
+	/* Sub-range of size indices starting at the start:th index of the range. */
+	constexpr IndexRange slice(std::int64_t start, std::int64_t size) const
+	{
+		assert(start >= 0 && size >= 0 && (size == 0 || start + size <= m_size));
+		return IndexRange(m_start + start, size);
+	}
+
+	/* Iteration over the indices, for (std::int64_t i : range). */
+	class Iterator {
+	public:
+		constexpr explicit Iterator(std::int64_t index) : m_index(index) {}
+		constexpr std::int64_t operator*() const { return m_index; }
+		constexpr Iterator& operator++()
+		{
+			m_index++;
+			return *this;
+		}
+		constexpr bool operator!=(const Iterator& other) const { return m_index != other.m_index; }
+
+	private:
+		std::int64_t m_index;
+	};
+	constexpr Iterator begin() const { return Iterator(m_start); }
+	constexpr Iterator end() const { return Iterator(one_after_last()); }
+
+private:
+	std::int64_t m_start = 0;
+	std::int64_t m_size = 0;
+};
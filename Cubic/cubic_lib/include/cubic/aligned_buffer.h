@@ -0,0 +1,100 @@
+#pragma once
+/* Aligned, optionally huge page backed, owning buffers for grids and batch solver input / output.
+*
+* Provided under the Unlicense License (public domain, see license terms at http://unlicense.org/).
+*/
+#include<cstddef>
+#include<cstdint>
+#include<type_traits>
+#include<utility>
+
+
+constexpr std::size_t CACHE_LINE_SIZE = 64;
+constexpr std::size_t HUGE_PAGE_SIZE = std::size_t(2) << 20;
+
+/**
+ * Allocation options of 'AlignedBuffer'.
+ *
+ * Pages of a large allocation are placed on the NUMA node of the thread first writing to them (first touch). For
+ * placement to match the threads processing the buffer, either let the parallel loop producing the data write it
+ * first (memory is not initialized by default), or set 'first_touch_items' to zero the buffer up front with the same
+ * schedule(static) partition as a parallel loop over that many items (e.g. N for the coefficients and roots of N
+ * equations solved by 'cubic_roots_batch()'). The partition depends on the number of OpenMP threads, which should
+ * then be the same for the allocation and the consumer.
+ */
+struct AllocConfig {
+	/* Alignment in bytes, a power of two. */
+	std::size_t alignment = CACHE_LINE_SIZE;
+	/* Align to HUGE_PAGE_SIZE and request transparent huge pages (madvise(MADV_HUGEPAGE), Linux only) for the whole
+	 * huge pages of the allocation, a tail shorter than HUGE_PAGE_SIZE keeps regular pages. */
+	bool huge_pages = false;
+	/* If > 0, zero the buffer in parallel partitioned as 'omp for schedule(static)' over this many items. */
+	std::int64_t first_touch_items = 0;
+};
+
+/* Raw allocation used by 'AlignedBuffer', throws std::bad_alloc on failure. */
+void* aligned_allocate(std::size_t bytes, const AllocConfig& config);
+void aligned_deallocate(void* ptr);
+
+/**
+ * Zero bytes[0 .. size) in parallel, each thread writing the range of the items it is assigned by 'omp for
+ * schedule(static)' over nitems equally sized items.
+ */
+void first_touch(void* bytes, std::size_t size, std::int64_t nitems);
+
+
+/**
+ * Owning (move only) array of n trivially copyable elements allocated by 'aligned_allocate()'. Elements are left
+ * uninitialized unless 'AllocConfig::first_touch_items' is set.
+ */
+template<typename T>
+class AlignedBuffer {
+	static_assert(std::is_trivially_copyable<T>::value, "AlignedBuffer elements are not constructed.");
+public:
+	AlignedBuffer() = default;
+
+	explicit AlignedBuffer(std::int64_t n, const AllocConfig& config = AllocConfig())
+		: m_data(static_cast<T*>(aligned_allocate(n * sizeof(T), config))), m_size(n)
+	{
+		if (config.first_touch_items > 0) {
+			first_touch(m_data, n * sizeof(T), config.first_touch_items);
+		}
+	}
+
+	~AlignedBuffer()
+	{
+		aligned_deallocate(m_data);
+	}
+
+	AlignedBuffer(AlignedBuffer&& other) noexcept
+		: m_data(std::exchange(other.m_data, nullptr)), m_size(std::exchange(other.m_size, 0))
+	{
+	}
+
+	AlignedBuffer& operator=(AlignedBuffer&& other) noexcept
+	{
+		std::swap(m_data, other.m_data);
+		std::swap(m_size, other.m_size);
+		return *this;
+	}
+
+	AlignedBuffer(const AlignedBuffer&) = delete;
+	AlignedBuffer& operator=(const AlignedBuffer&) = delete;
+
+	T* data() { return m_data; }
+	const T* data() const { return m_data; }
+	std::int64_t size() const { return m_size; }
+	bool empty() const { return m_size == 0; }
+
+	T& operator[](std::int64_t i) { return m_data[i]; }
+	const T& operator[](std::int64_t i) const { return m_data[i]; }
+
+	T* begin() { return m_data; }
+	T* end() { return m_data + m_size; }
+	const T* begin() const { return m_data; }
+	const T* end() const { return m_data + m_size; }
+
+private:
+	T* m_data = nullptr;
+	std::int64_t m_size = 0;
+};
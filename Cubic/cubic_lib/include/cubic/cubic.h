@@ -1,9 +1,14 @@
 #pragma once
 /* Algorithms for computing real roots of a cubic or quadratic equation (3rd or 2nd order polynomial).
 *
+* Solvers are instantiated for float, double and long double, and for __float128 if CUBIC_FLOAT128 is defined
+* (see 'fp_traits.h'). The fast solver is only available for float and double.
+*
 * Provided under the Unlicense License (public domain, see license terms at http://unlicense.org/).
 */
 
+/* Default iteration bound of 'cubic_roots_qbc_bounded()'. */
+constexpr int QBC_MAX_ITER = 16;
 
 template<typename FP>
 using QDRT_SOLVER = int (*)(FP, FP, FP, FP*);
@@ -44,6 +49,44 @@ int quadratic_roots(FP a, FP b, FP c, FP* xroots);
 template<typename FP>
 int cubic_roots(FP a, FP b, FP c, FP d, FP* xroots);
 
+/**
+ * Compute the real roots for the cubic equation
+ *
+ *		ax^3 + bx^2 + cx + d = 0
+ *
+ * Fast version of 'cubic_roots()' replacing acos(), cos() and cbrt() with the bounded error approximations
+ * in 'fast_math.h'.
+ */
+template<typename FP>
+int cubic_roots_fast(FP a, FP b, FP c, FP d, FP* xroots);
+
+/**
+ * Compute the real roots for the monic cubic equation
+ *
+ *		x^3 + bx^2 + cx + d = 0
+ */
+template<typename FP>
+int monic_cubic_roots(FP b, FP c, FP d, FP* xroots);
+
+/**
+ * Compute the real roots for the depressed cubic equation
+ *
+ *		x^3 + px + q = 0
+ */
+template<typename FP>
+int depressed_cubic_roots(FP p, FP q, FP* xroots);
+
+/**
+ * Compute the three real roots for the depressed cubic equation
+ *
+ *		x^3 + px + q = 0
+ *
+ * where p <= 0 and the discriminant 4p^3 + 27q^2 <= 0 (e.g. characteristic equations of symmetric matrices).
+ * Roots are ordered xroots[0] >= xroots[1] >= xroots[2].
+ */
+template<typename FP>
+int depressed_cubic_roots_trig(FP p, FP q, FP* xroots);
+
 
 /**
 * Compute the real roots for the quadratic equation
@@ -59,4 +102,15 @@ int qdrtc(FP A, FP B, FP C, FP* xroots);
  *		ax^3 + bx^2 + cx + d = 0
  */
 template<typename FP>
-int cubic_roots_qbc(FP A, FP B, FP C, FP D, FP* xroots);
\ No newline at end of file
+int cubic_roots_qbc(FP A, FP B, FP C, FP D, FP* xroots);
+/**
+ * Compute the real roots for the cubic equation
+ *
+ *		ax^3 + bx^2 + cx + d = 0
+ *
+ * Same as 'cubic_roots_qbc()' with the Newton iteration bounded to max_iter steps, giving a worst-case bound on
+ * the execution time. If the iteration has not converged within max_iter steps the roots are computed by the
+ * closed form 'cubic_roots()' instead and converged (if not null) is set to false.
+ */
+template<typename FP>
+int cubic_roots_qbc_bounded(FP A, FP B, FP C, FP D, FP* xroots, int max_iter = QBC_MAX_ITER, bool* converged = nullptr);
@@ -0,0 +1,122 @@
+#pragma once
+/* Batch algorithms for computing real roots of many cubic equations (3rd order polynomials).
+*
+* Provided under the Unlicense License (public domain, see license terms at http://unlicense.org/).
+*/
+#include "cubic/IndexRange.h"
+#include "cubic/cubic.h"
+
+#include<cstdint>
+#include<functional>
+#include<limits>
+#include<vector>
+
+
+/**
+ * Compute the real roots for N cubic equations
+ *
+ *		a_i x^3 + b_i x^2 + c_i x + d_i = 0
+ *
+ * Coefficients are stored row-wise in coeffs[4 * N] as [a_i, b_i, c_i, d_i]. Roots of the i:th equation are
+ * written to xroots[3 * i] ... xroots[3 * i + nroots[i] - 1], remaining (padding) elements are left untouched.
+ */
+template<typename FP>
+void cubic_roots_batch(const FP* coeffs, std::int64_t N, FP* xroots, int* nroots, CBRT_SOLVER<FP> solver = &cubic_roots<FP>);
+
+/**
+ * Compute the real roots for N monic cubic equations
+ *
+ *		x^3 + b_i x^2 + c_i x + d_i = 0
+ *
+ * Coefficients are stored row-wise in coeffs[3 * N] as [b_i, c_i, d_i], output is the same as for 'cubic_roots_batch()'.
+ */
+template<typename FP>
+void monic_cubic_roots_batch(const FP* coeffs, std::int64_t N, FP* xroots, int* nroots);
+
+/**
+ * Compute the real roots for N depressed cubic equations
+ *
+ *		x^3 + p_i x + q_i = 0
+ *
+ * Coefficients are stored row-wise in coeffs[2 * N] as [p_i, q_i], output is the same as for 'cubic_roots_batch()'.
+ */
+template<typename FP>
+void depressed_cubic_roots_batch(const FP* coeffs, std::int64_t N, FP* xroots, int* nroots);
+
+/**
+ * Compute the real roots for N cubic equations using the closed form solver, grouping equations by branch.
+ *
+ * Equations are processed in blocks: the reduced coefficients and the discriminant are first computed for every
+ * equation in the block, indices are then partitioned into worklists for the trigonometric (three real roots),
+ * Cardano (one real root) and degenerate (a = 0, d = 0 or triple root) branches. Each worklist is solved by a
+ * branch free kernel over dense lanes and the roots are scattered to the output, avoiding divergent lanes that
+ * would evaluate both the trigonometric and the cube root math. Degenerate equations fall back to 'cubic_roots()'.
+ *
+ * Input and output layout is the same as for 'cubic_roots_batch()'. Results equal 'cubic_roots()' except that
+ * the acos() argument is clamped to [-1, 1].
+ */
+template<typename FP>
+void cubic_roots_classified(const FP* coeffs, std::int64_t N, FP* xroots, int* nroots);
+
+/**
+ * Compute the real roots for N cubic equations using the closed form solver with selective QBC fallback.
+ *
+ * Roots from 'cubic_roots()' are verified with a compensated evaluation of the cubic, lanes where any root has a
+ * relative residual
+ *
+ *		|f(x)| / (|a||x|^3 + |b|x^2 + |c||x| + |d|) > tol
+ *
+ * are gathered into a compacted worklist and re-solved in parallel with 'cubic_roots_qbc()'. Input and output
+ * layout is the same as for 'cubic_roots_batch()'.
+ *
+ * Returns the number of equations re-solved by QBC.
+ */
+template<typename FP>
+std::int64_t cubic_roots_hybrid(const FP* coeffs, std::int64_t N, FP* xroots, int* nroots, FP tol = (FP)16.0 * std::numeric_limits<FP>::epsilon());
+
+/**
+ * Compute the real roots for N cubic equations with the given solver, refining ill-conditioned roots.
+ *
+ * Roots with an estimated condition number 'cubic_root_condition()' above cond_threshold (e.g. near-multiple
+ * roots) are refined by Newton iterations on the compensated (double-double for double) residual, see
+ * 'refine_root_compensated()' in 'eft.h'. Input and output layout is the same as for 'cubic_roots_batch()'.
+ *
+ * Returns the number of equations with at least one refined root.
+ */
+template<typename FP>
+std::int64_t cubic_roots_refined(const FP* coeffs, std::int64_t N, FP* xroots, int* nroots, FP cond_threshold = (FP)1e3, CBRT_SOLVER<FP> solver = &cubic_roots<FP>);
+
+/**
+ * Compute the real roots for N cubic equations and store them compacted in CSR (compressed sparse row) form.
+ *
+ * Coefficients are stored row-wise in coeffs[4 * N] as [a_i, b_i, c_i, d_i]. Roots of the i:th equation are
+ * written to xroots[offsets[i]] ... xroots[offsets[i + 1] - 1], offsets must hold N + 1 elements and xroots
+ * is resized to fit all roots.
+ *
+ * Compaction runs in parallel: each thread solves a contiguous chunk into a local buffer and counts its roots,
+ * the per-thread counts are prefix-summed and each thread scatters its buffer into xroots.
+ *
+ * Returns the total number of real roots (offsets[N]).
+ */
+template<typename FP>
+std::int64_t cubic_roots_csr(const FP* coeffs, std::int64_t N, std::vector<FP>& xroots, std::int64_t* offsets, CBRT_SOLVER<FP> solver = &cubic_roots<FP>);
+
+/* Grid view, see 'cubic/ndgrid.h'. */
+template <typename FP, std::int64_t ndim>
+class NdgridView;
+
+/* Consumer of the roots of a chunk of equations in 'cubic_roots_grid()'. */
+template<typename FP>
+using GRID_ROOTS_CALLBACK = std::function<void(IndexRange chunk, const FP* coeffs, const FP* xroots, const int* nroots)>;
+
+/**
+ * Compute the real roots for the cubic equations of a parameter sweep, the coefficients [a, b, c, d] of the j:th
+ * equation are the coordinates of point j in the 4D grid (see 'NdgridView').
+ *
+ * The grid is never materialized: equations are processed in chunks of chunk_size, the coefficients of each chunk
+ * are generated and solved in parallel into buffers reused over the chunks. For each chunk (in order) f is called
+ * with the range of grid points and the coefficients and roots of the chunk, laid out as for 'cubic_roots_batch()'
+ * (local to the chunk). Memory use is O(chunk_size) independent of the grid size.
+ */
+template<typename FP>
+void cubic_roots_grid(const NdgridView<FP, 4>& grid, std::int64_t chunk_size, const GRID_ROOTS_CALLBACK<FP>& f, CBRT_SOLVER<FP> solver = &cubic_roots<FP>);
@@ -0,0 +1,71 @@
+#pragma once
+/* C entry points of the root solvers, the API of the 'libcubic' shared library and callable through ctypes / cffi
+* and from numba compiled code.
+*
+* Functions are suffixed _d (double) and _f (float). Scalar solvers write the real roots to xroots (3 elements for
+* cubic, 2 for quadratic equations) and return the number of roots, batch solvers use the layout of
+* 'cubic_roots_batch()' in 'cubic_batch.h'. Only these functions are exported from the shared library, compatible
+* changes keep CUBIC_ABI_VERSION.
+*
+* Provided under the Unlicense License (public domain, see license terms at http://unlicense.org/).
+*/
+#include <stdint.h>
+
+#define CUBIC_ABI_VERSION 1
+
+/* Symbol export: define CUBIC_SHARED_BUILD when building and CUBIC_SHARED when linking the shared library. */
+#if defined(_WIN32)
+#if defined(CUBIC_SHARED_BUILD)
+#define CUBIC_API __declspec(dllexport)
+#elif defined(CUBIC_SHARED)
+#define CUBIC_API __declspec(dllimport)
+#else
+#define CUBIC_API
+#endif
+#else
+#define CUBIC_API __attribute__((visibility("default")))
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* CUBIC_ABI_VERSION of the library. */
+CUBIC_API int cubic_abi_version(void);
+
+/* Scalar */
+CUBIC_API int cubic_roots_d(double a, double b, double c, double d, double* xroots);
+CUBIC_API int cubic_roots_f(float a, float b, float c, float d, float* xroots);
+CUBIC_API int cubic_roots_fast_d(double a, double b, double c, double d, double* xroots);
+CUBIC_API int cubic_roots_fast_f(float a, float b, float c, float d, float* xroots);
+CUBIC_API int cubic_roots_qbc_d(double a, double b, double c, double d, double* xroots);
+CUBIC_API int cubic_roots_qbc_f(float a, float b, float c, float d, float* xroots);
+CUBIC_API int quadratic_roots_d(double a, double b, double c, double* xroots);
+CUBIC_API int quadratic_roots_f(float a, float b, float c, float* xroots);
+CUBIC_API int qdrtc_d(double a, double b, double c, double* xroots);
+CUBIC_API int qdrtc_f(float a, float b, float c, float* xroots);
+/* QBC with at most max_iter iterations, converged (if not NULL) is set to 0 if it fell back to cubic_roots. */
+CUBIC_API int cubic_roots_qbc_bounded_d(double a, double b, double c, double d, double* xroots, int max_iter, int* converged);
+CUBIC_API int cubic_roots_qbc_bounded_f(float a, float b, float c, float d, float* xroots, int max_iter, int* converged);
+
+/* Batch, solve N equations with coefficients coeffs[4 * N] in parallel (OpenMP), roots to xroots[3 * N]. */
+CUBIC_API void cubic_roots_batch_d(const double* coeffs, int64_t N, double* xroots, int* nroots);
+CUBIC_API void cubic_roots_batch_f(const float* coeffs, int64_t N, float* xroots, int* nroots);
+CUBIC_API void cubic_roots_qbc_batch_d(const double* coeffs, int64_t N, double* xroots, int* nroots);
+CUBIC_API void cubic_roots_qbc_batch_f(const float* coeffs, int64_t N, float* xroots, int* nroots);
+CUBIC_API void cubic_roots_classified_d(const double* coeffs, int64_t N, double* xroots, int* nroots);
+CUBIC_API void cubic_roots_classified_f(const float* coeffs, int64_t N, float* xroots, int* nroots);
+
+/* Parallel, number of OpenMP threads used by batch calls from the calling thread (n <= 0 uses one per processor). */
+CUBIC_API void cubic_set_num_threads(int n);
+CUBIC_API int cubic_get_max_threads(void);
+
+/* Instrumented batch solvers, return the number of equations re-solved by QBC (hybrid) or refined (refined). */
+CUBIC_API int64_t cubic_roots_hybrid_d(const double* coeffs, int64_t N, double* xroots, int* nroots, double tol);
+CUBIC_API int64_t cubic_roots_hybrid_f(const float* coeffs, int64_t N, float* xroots, int* nroots, float tol);
+CUBIC_API int64_t cubic_roots_refined_d(const double* coeffs, int64_t N, double* xroots, int* nroots, double cond_threshold);
+CUBIC_API int64_t cubic_roots_refined_f(const float* coeffs, int64_t N, float* xroots, int* nroots, float cond_threshold);
+
+#ifdef __cplusplus
+}
+#endif
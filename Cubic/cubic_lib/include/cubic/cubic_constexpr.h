@@ -0,0 +1,367 @@
+#pragma once
+/* Constexpr algorithms for computing real roots of a cubic or quadratic equation (3rd or 2nd order polynomial).
+*
+* Mirrors 'cubic_roots()', 'quadratic_roots()' and 'qdrtc()' but replaces the non-constexpr <cmath> functions with
+* constexpr implementations, allowing roots to be computed at compile time (C++17):
+*
+*	constexpr auto r = cubic_roots_ce(1.0, -6.0, 11.0, -6.0);
+*	static_assert(r.n == 3, "");
+*
+* The math functions are accurate to a few ULP, results may therefore differ in the last digits from the runtime solvers.
+*
+* Provided under the Unlicense License (public domain, see license terms at http://unlicense.org/).
+*/
+#include<limits>
+
+
+/**
+* Real roots returned by the constexpr solvers, the first n elements of x are valid.
+*/
+template<typename FP, int N>
+struct Roots {
+	int n;
+	FP x[N];
+
+	constexpr FP operator[](int i) const
+	{
+		return x[i];
+	}
+};
+
+namespace ce {
+
+	template<typename FP>
+	constexpr FP abs(FP x)
+	{
+		return x < FP(0) ? -x : x;
+	}
+
+	template<typename FP>
+	constexpr FP copysign(FP x, FP s)
+	{
+		return (s < FP(0)) == (x < FP(0)) ? x : -x;
+	}
+
+	/**
+	* Square root computed by Newton iterations after scaling x into [0.25, 1).
+	*/
+	template<typename FP>
+	constexpr FP sqrt(FP x)
+	{
+		if (!(x > FP(0)) || x == std::numeric_limits<FP>::infinity()) {
+			return x == FP(0) || x == std::numeric_limits<FP>::infinity() ? x : std::numeric_limits<FP>::quiet_NaN();
+		}
+		/* sqrt(x * 4^k) = sqrt(x) * 2^k */
+		FP scale = FP(1);
+		while (x >= FP(1)) {
+			x *= FP(0.25);
+			scale *= FP(2);
+		}
+		while (x < FP(0.25)) {
+			x *= FP(4);
+			scale *= FP(0.5);
+		}
+		FP r = FP(0.5) + FP(0.5) * x;
+		for (int i = 0; i < 8; i++) {
+			r = FP(0.5) * (r + x / r);
+		}
+		return r * scale;
+	}
+
+	/**
+	* Cube root computed by Newton iterations after scaling |x| into [0.125, 1).
+	*/
+	template<typename FP>
+	constexpr FP cbrt(FP x)
+	{
+		if (x == FP(0) || x != x || abs(x) == std::numeric_limits<FP>::infinity()) {
+			return x;
+		}
+		FP a = abs(x);
+		/* cbrt(x * 8^k) = cbrt(x) * 2^k */
+		FP scale = FP(1);
+		while (a >= FP(1)) {
+			a *= FP(0.125);
+			scale *= FP(2);
+		}
+		while (a < FP(0.125)) {
+			a *= FP(8);
+			scale *= FP(0.5);
+		}
+		FP r = FP(0.5) + FP(0.5) * a;
+		for (int i = 0; i < 8; i++) {
+			r = r - (r * r * r - a) / (FP(3) * r * r);
+		}
+		return copysign(r * scale, x);
+	}
+
+	template<typename FP>
+	constexpr FP pi()
+	{
+		return (FP)3.141592653589793238462643383279502884197169399375105820974944592307816406286;
+	}
+
+	/**
+	* Arc tangent, argument is reduced below 0.125 using atan(x) = 2 atan(x / (1 + sqrt(1 + x^2)))
+	* before the Taylor series is evaluated.
+	*/
+	template<typename FP>
+	constexpr FP atan(FP x)
+	{
+		if (x < FP(0)) {
+			return -atan(-x);
+		}
+		if (x > FP(1)) {
+			return pi<FP>() / FP(2) - atan(FP(1) / x);
+		}
+		FP mul = FP(1);
+		while (x > FP(0.125)) {
+			x = x / (FP(1) + sqrt(FP(1) + x * x));
+			mul *= FP(2);
+		}
+		/* atan(x) = x - x^3/3 + x^5/5 - ... */
+		FP xx = x * x;
+		FP term = x;
+		FP sum = FP(0);
+		for (int k = 0; k < 64; k++) {
+			FP prev = sum;
+			sum += term / FP(2 * k + 1);
+			term *= -xx;
+			if (sum == prev) {
+				break;
+			}
+		}
+		return mul * sum;
+	}
+
+	template<typename FP>
+	constexpr FP acos(FP x)
+	{
+		if (x < FP(-1) || x > FP(1)) {
+			return std::numeric_limits<FP>::quiet_NaN();
+		}
+		if (x == FP(-1)) {
+			return pi<FP>();
+		}
+		/* acos(x) = 2 atan(sqrt((1 - x) / (1 + x))) */
+		return FP(2) * atan(sqrt((FP(1) - x) / (FP(1) + x)));
+	}
+
+	/* Taylor series for sin(x) and cos(x) in |x| <= pi / 4. */
+	template<typename FP>
+	constexpr FP sin_series(FP x)
+	{
+		FP xx = x * x;
+		FP term = x;
+		FP sum = x;
+		for (int k = 1; k < 32; k++) {
+			term *= -xx / FP((2 * k) * (2 * k + 1));
+			FP prev = sum;
+			sum += term;
+			if (sum == prev) {
+				break;
+			}
+		}
+		return sum;
+	}
+	template<typename FP>
+	constexpr FP cos_series(FP x)
+	{
+		FP xx = x * x;
+		FP term = FP(1);
+		FP sum = FP(1);
+		for (int k = 1; k < 32; k++) {
+			term *= -xx / FP((2 * k - 1) * (2 * k));
+			FP prev = sum;
+			sum += term;
+			if (sum == prev) {
+				break;
+			}
+		}
+		return sum;
+	}
+
+	/**
+	* Cosine with reduction to the octant |x| <= pi / 4. Reduction is exact only for moderate |x|
+	* which is sufficient for the angles in [-2pi, 2pi] occuring in the cubic solver.
+	*/
+	template<typename FP>
+	constexpr FP cos(FP x)
+	{
+		constexpr FP PIHalf = pi<FP>() / FP(2);
+		x = abs(x);
+		long long quadrant = (long long)(x / PIHalf + FP(0.5));
+		FP r = x - FP(quadrant) * PIHalf;
+		switch (quadrant & 3) {
+		case 0: return cos_series(r);
+		case 1: return -sin_series(r);
+		case 2: return -cos_series(r);
+		default: return sin_series(r);
+		}
+	}
+}
+
+/**
+* Compute the real roots for the quadratic equation
+*
+*		ax^2 + bx + c = 0
+*
+* Constexpr version of 'quadratic_roots()'.
+*/
+template<typename FP>
+constexpr Roots<FP, 2> quadratic_roots_ce(FP a, FP b, FP c)
+{
+	constexpr FP EPSILON = std::numeric_limits<FP>::epsilon();
+	Roots<FP, 2> r{ 0, {} };
+
+	if (ce::abs(a) < EPSILON)
+	{
+		/* Linear equation */
+		if (ce::abs(b) > EPSILON)
+		{
+			r.x[0] = -c / b;
+			r.n = 1;
+		}
+		return r;
+	}
+	b = b / a;
+	c = c / a;
+
+	FP q = b * b - (FP)4.0 * c;
+	if (q >= (FP)0.0)
+	{
+		FP c2 = (FP)2.0 * c;
+		q = ce::sqrt(q);
+		if (b < (FP)0.0) {
+			r.x[0] = c2 / (q - b);
+			r.x[1] = (q - b) * (FP)0.5;
+		}
+		else {
+			r.x[0] = (-b - q) * (FP)0.5;
+			r.x[1] = c2 / (-q - b);
+		}
+		r.n = 2;
+	}
+	return r;
+}
+
+/**
+* Compute the real roots for the quadratic equation
+*
+*		ax^2 + bx + c = 0
+*
+* Constexpr version of 'qdrtc()'.
+*/
+template<typename FP>
+constexpr Roots<FP, 2> qdrtc_ce(FP A, FP B, FP C)
+{
+	constexpr FP EPSILON = std::numeric_limits<FP>::epsilon();
+	Roots<FP, 2> r{ 0, {} };
+
+	if (ce::abs(A) < EPSILON)
+	{
+		/* Linear equation */
+		if (ce::abs(B) > EPSILON)
+		{
+			r.x[0] = -C / B;
+			r.n = 1;
+		}
+		return r;
+	}
+
+	FP b = -B / (FP)2.0;
+	FP q = b * b - A * C;
+	if (q >= (FP)0.0) {
+		FP s = b + ce::copysign(ce::sqrt(q), b);
+		if (s == (FP)0.0) {
+			r.x[0] = C / A;
+			r.x[1] = -r.x[0];
+		}
+		else {
+			r.x[0] = C / s;
+			r.x[1] = s / A;
+		}
+		r.n = 2;
+	}
+	return r;
+}
+
+/**
+ * Compute the real roots for the cubic equation
+ *
+ *		ax^3 + bx^2 + cx + d = 0
+ *
+ * Constexpr version of 'cubic_roots()'.
+ */
+template<typename FP>
+constexpr Roots<FP, 3> cubic_roots_ce(FP a, FP b, FP c, FP d)
+{
+	constexpr FP PI2over3 = (FP)(ce::pi<FP>() * (FP)2.0 / (FP)3.0);
+	constexpr FP third = (FP)(1.0 / 3.0);
+	constexpr FP zero = (FP)0.0;
+	constexpr FP EPSILON = std::numeric_limits<FP>::epsilon();
+	Roots<FP, 3> r{ 0, {} };
+
+	int n = 0;
+	if (ce::abs(d) < EPSILON)
+	{
+		/* First solution is x = 0 */
+		r.x[0] = zero;
+		n = 1;
+		/* Divide all terms by x, converting to quadratic equation */
+		d = c;
+		c = b;
+		b = a;
+		a = zero;
+	}
+	if (ce::abs(a) < EPSILON)
+	{
+		Roots<FP, 2> q = quadratic_roots_ce<FP>(b, c, d);
+		for (int i = 0; i < q.n; i++) {
+			r.x[n + i] = q.x[i];
+		}
+		r.n = n + q.n;
+		return r;
+	}
+
+	b = b / a;
+	c = c / a;
+	d = d / a;
+
+	FP bover3 = b * third;
+	FP p = c - bover3 * b;
+	FP halfq = bover3 * bover3 * bover3 - (FP)0.5 * bover3 * c + (FP)0.5 * d;
+	FP yy = p / (FP)27.0 * p * p + halfq * halfq;
+
+	if (yy < (FP)0.0) /* Sqrt is negative: three real solutions */
+	{
+		if (ce::abs(p) < EPSILON)
+		{
+			r.x[0] = -bover3;
+			r.x[1] = r.x[0];
+			r.x[2] = r.x[0];
+		}
+		else
+		{
+			FP uu = (FP)(-4.0 / 3.0) * p;
+			FP u = ce::sqrt(uu);
+			FP theta = ce::acos((FP)-8.0 * halfq / (u * uu)) * third;
+			r.x[0] = u * ce::cos(theta) - bover3;
+			r.x[1] = u * ce::cos(theta - PI2over3) - bover3;
+			r.x[2] = u * ce::cos(theta + PI2over3) - bover3;
+		}
+		r.n = 3;
+	}
+	else
+	{
+		/*  Sqrt is positive: one real solution */
+		FP y = ce::sqrt(yy);
+		FP uuu = y - halfq;
+		FP vvv = -y - halfq;
+		FP www = ce::abs(uuu) > ce::abs(vvv) ? uuu : vvv;
+		FP w = ce::cbrt(www);
+		r.x[0] = w - p / ((FP)3.0 * w) - bover3;
+		r.n = 1;
+	}
+	return r;
+}
@@ -0,0 +1,68 @@
+#pragma once
+/* Micro-batching service solving cubic equations submitted one at a time from many threads.
+*
+* Provided under the Unlicense License (public domain, see license terms at http://unlicense.org/).
+*/
+#include "cubic/cubic_constexpr.h"
+
+#include<chrono>
+#include<cstdint>
+#include<functional>
+#include<future>
+#include<memory>
+
+
+/**
+ * Solver service gathering single equations into batches.
+ *
+ * Producers submit equations from any thread into a bounded lock-free MPMC queue. A pool of worker threads pops
+ * pending requests into a batch until 'max_batch' requests are gathered or 'max_wait' has passed since the first
+ * request of the batch was popped, the batch is then solved by 'cubic_roots_classified()' and each request is
+ * fulfilled through its future or callback. Small 'max_batch' / 'max_wait' favor latency, large values throughput.
+ *
+ * Results are the same as for 'cubic_roots_classified()'. If the queue is full 'submit()' yields until a slot is
+ * free. The destructor solves all requests submitted before it is called and then joins the workers.
+ */
+template<typename FP>
+class CubicService {
+public:
+	using Result = Roots<FP, 3>;
+	using Callback = std::function<void(const Result&)>;
+
+	struct Config {
+		/* Number of worker threads. */
+		int num_workers = 1;
+		/* Maximum number of equations solved per batch. */
+		int max_batch = 64;
+		/* Maximum time a popped request waits for the batch to fill. */
+		std::chrono::microseconds max_wait = std::chrono::microseconds(50);
+		/* Queue capacity (rounded up to a power of two). */
+		std::size_t queue_capacity = 1 << 16;
+	};
+
+	explicit CubicService(const Config& config = Config());
+	~CubicService();
+
+	CubicService(const CubicService&) = delete;
+	CubicService& operator=(const CubicService&) = delete;
+
+	/**
+	 * Submit the equation ax^3 + bx^2 + cx + d = 0, the returned future holds the real roots.
+	 */
+	std::future<Result> submit(FP a, FP b, FP c, FP d);
+
+	/**
+	 * Submit the equation ax^3 + bx^2 + cx + d = 0, the callback is invoked with the real roots from a worker
+	 * thread and must not throw.
+	 */
+	void submit(FP a, FP b, FP c, FP d, Callback callback);
+
+	/**
+	 * Number of batches solved so far.
+	 */
+	std::uint64_t num_batches() const;
+
+private:
+	struct Impl;
+	std::unique_ptr<Impl> m_impl;
+};
@@ -0,0 +1,152 @@
+#pragma once
+/* Error-free transformations (EFT) and compensated polynomial evaluation.
+*
+* Compensated Horner evaluates a polynomial as accurately as if computed in twice the working precision and then
+* rounded, see 'Compensated Horner Scheme' authored by S. Graillat, P. Langlois and N. Louvet.
+*
+* Provided under the Unlicense License (public domain, see license terms at http://unlicense.org/).
+*/
+#include<cmath>
+#include<limits>
+
+
+/**
+* Compute s + e = a + b exactly where s = fl(a + b) (Knuth's TwoSum).
+*/
+template<typename FP>
+inline void two_sum(FP a, FP b, FP& s, FP& e)
+{
+	s = a + b;
+	FP z = s - a;
+	e = (a - (s - z)) + (b - z);
+}
+
+/**
+* Compute p + e = a * b exactly where p = fl(a * b) (TwoProd using a fused multiply-add).
+*/
+template<typename FP>
+inline void two_prod(FP a, FP b, FP& p, FP& e)
+{
+	p = a * b;
+	e = std::fma(a, b, -p);
+}
+
+/**
+* Evaluate the cubic function for a given x using compensated Horner.
+*
+ * The cubic function is a polynomial function on the form
+*	f(x) = ax^3 + bx^2 + cx + d
+*/
+template<typename FP>
+inline FP cubic_compensated(FP a, FP b, FP c, FP d, FP x)
+{
+	FP p, s, pe, se;
+	/* s = a * x + b */
+	two_prod(a, x, p, pe);
+	two_sum(p, b, s, se);
+	FP err = pe + se;
+	/* s = s * x + c */
+	two_prod(s, x, p, pe);
+	two_sum(p, c, s, se);
+	err = err * x + (pe + se);
+	/* s = s * x + d */
+	two_prod(s, x, p, pe);
+	two_sum(p, d, s, se);
+	err = err * x + (pe + se);
+	return s + err;
+}
+
+/**
+* Evaluate the quadratic function for a given x using compensated Horner.
+*
+ * The quadratic function is a polynomial function on the form
+*	f(x) = ax^2 + bx + c
+*/
+template<typename FP>
+inline FP quadratic_compensated(FP a, FP b, FP c, FP x)
+{
+	FP p, s, pe, se;
+	two_prod(a, x, p, pe);
+	two_sum(p, b, s, se);
+	FP err = pe + se;
+	two_prod(s, x, p, pe);
+	two_sum(p, c, s, se);
+	err = err * x + (pe + se);
+	return s + err;
+}
+
+/**
+* Evaluate the cubic function and its derivative for a given x, using the Horner structure of the QBC solver
+*
+*	q0 = ax, b1 = q0 + b, c2 = b1 x + c, f(x) = c2 x + d, f'(x) = (q0 + b1) x + c2
+*
+* where f(x) is compensated (computed as accurately as in twice the working precision, i.e. double-double for
+* double) and f'(x) is evaluated in working precision.
+*/
+template<typename FP>
+inline void cubic_eval_compensated(FP a, FP b, FP c, FP d, FP x, FP& f, FP& df)
+{
+	FP q0, b1, c2, p, pe, se;
+	/* b1 = a * x + b */
+	two_prod(a, x, q0, pe);
+	two_sum(q0, b, b1, se);
+	FP b1e = pe + se;
+	/* c2 = b1 * x + c */
+	two_prod(b1, x, p, pe);
+	two_sum(p, c, c2, se);
+	FP c2e = b1e * x + (pe + se);
+	/* f = c2 * x + d */
+	two_prod(c2, x, p, pe);
+	two_sum(p, d, f, se);
+	f += c2e * x + (pe + se);
+	df = (q0 + b1) * x + c2;
+}
+
+/**
+* Condition number of the root x of the cubic function,
+*
+*	cond(x) = (|a||x|^3 + |b|x^2 + |c||x| + |d|) / (|x||f'(x)|)
+*
+* i.e. the relative change in x caused by a relative perturbation of the coefficients (infinite at multiple roots).
+*/
+template<typename FP>
+inline FP cubic_root_condition(FP a, FP b, FP c, FP d, FP x)
+{
+	using namespace std;
+	FP ax = abs(x);
+	FP scale = ((abs(a) * ax + abs(b)) * ax + abs(c)) * ax + abs(d);
+	FP df = ((FP)3.0 * a * x + (FP)2.0 * b) * x + c;
+	return scale / (ax * abs(df));
+}
+
+/**
+* Refine the root x of the cubic function with Newton iterations using the compensated residual from
+* 'cubic_eval_compensated()'. Iteration stops when the correction is below one ULP, the residual no longer
+* decreases (x is kept at the smallest residual) or after max_iter iterations. Newton converges linearly towards
+* multiple roots, max_iter bounds the cost for such roots.
+*
+* Returns the refined root.
+*/
+template<typename FP>
+inline FP refine_root_compensated(FP a, FP b, FP c, FP d, FP x, int max_iter = 16)
+{
+	using namespace std;
+	FP f, df;
+	cubic_eval_compensated(a, b, c, d, x, f, df);
+	for (int i = 0; i < max_iter && f != (FP)0.0 && df != (FP)0.0; i++) {
+		FP dx = f / df;
+		FP xn = x - dx;
+		FP fn, dfn;
+		cubic_eval_compensated(a, b, c, d, xn, fn, dfn);
+		if (!(abs(fn) < abs(f))) {
+			break;
+		}
+		x = xn;
+		f = fn;
+		df = dfn;
+		if (abs(dx) <= numeric_limits<FP>::epsilon() * abs(x)) {
+			break;
+		}
+	}
+	return x;
+}
@@ -0,0 +1,60 @@
+#pragma once
+/* Eigenvalues of 3x3 matrices computed from the characteristic cubic equation.
+*
+* Provided under the Unlicense License (public domain, see license terms at http://unlicense.org/).
+*/
+#include<cstdint>
+
+
+/**
+ * Compute eigenvalues (and optionally eigenvectors) of the symmetric 3x3 matrix
+ *
+ *		| a00 a01 a02 |
+ *		| a01 a11 a12 |
+ *		| a02 a12 a22 |
+ *
+ * stored as A[6] = [a00, a01, a02, a11, a12, a22]. The matrix is scaled by its largest absolute entry and shifted
+ * by trace / 3 before the characteristic (depressed) cubic is built, avoiding overflow and reducing cancellation.
+ * The cubic is solved by the trigonometric method only, as all roots of a symmetric matrix are real. By default
+ * the standard library acos / cos are used, with FAST the polynomial approximations in 'fast_math.h' are used
+ * instead (faster and vectorizable, but each within a few ULP rather than correctly rounded). As for any
+ * trigonometric solver
+ * eigenvalues of multiplicity two or three are only accurate to about sqrt(epsilon) relative to the largest entry.
+ *
+ * Eigenvalues are written in ascending order to eval[3]. If evec is not null the corresponding orthonormal
+ * eigenvectors are written row-wise to evec[9] (evec[3 * k + j] is component j of the k:th eigenvector).
+ */
+template<typename FP, bool FAST = false>
+void eig3_sym(const FP* A, FP* eval, FP* evec = nullptr);
+
+/**
+ * Compute eigenvalues (and optionally eigenvectors) for N symmetric 3x3 matrices stored in SoA (structure of
+ * arrays) form: A[j * N + i] is entry j of the i:th matrix in the order used by 'eig3_sym()'.
+ *
+ * Eigenvalues are written to the planes eval[k * N + i] in ascending order. If evec is not null eigenvectors are
+ * written to the planes evec[(3 * k + j) * N + i]. Eigenvalues are computed in SIMD friendly (branch free) loops,
+ * results are identical to 'eig3_sym()' with the same FAST parameter.
+ */
+template<typename FP, bool FAST = false>
+void eig3_sym_batch(const FP* A, std::int64_t N, FP* eval, FP* evec = nullptr);
+
+/**
+ * Compute the (possibly complex) eigenvalues of the general 3x3 matrix stored row-wise as A[9] = [a00, a01, a02,
+ * a10, ..., a22]. The matrix is scaled by its largest absolute entry and shifted by trace / 3, the characteristic
+ * cubic t^3 + mt - det = 0 (m the sum of principal 2x2 minors) is then solved by the closed form solver.
+ *
+ * Eigenvalues are written as eval_re[k] + i eval_im[k]. If all are real (including multiple eigenvalues) they are
+ * ordered descending, otherwise eval_*[0] is the real eigenvalue (regardless of its magnitude relative to the real
+ * part of the pair) followed by the complex conjugate pair with eval_im[1] > 0. Returns the number of real
+ * eigenvalues (1 or 3).
+ */
+template<typename FP>
+int eig3(const FP* A, FP* eval_re, FP* eval_im);
+
+/**
+ * Compute eigenvalues for N general 3x3 matrices stored in SoA form: A[j * N + i] is entry j of the i:th matrix in
+ * the (row-wise) order used by 'eig3()'. Eigenvalues are written to the planes eval_re[k * N + i] and
+ * eval_im[k * N + i] ordered as in 'eig3()'. Matrices are processed in parallel (OpenMP).
+ */
+template<typename FP>
+void eig3_batch(const FP* A, std::int64_t N, FP* eval_re, FP* eval_im);
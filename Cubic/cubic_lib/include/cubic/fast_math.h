@@ -0,0 +1,140 @@
+#pragma once
+/* Fast approximations of the math functions used by the closed form cubic solver.
+*
+* Polynomial coefficients are Chebyshev interpolants (near-minimax) computed in extended precision, separate
+* (shorter) sets are used for float. Maximum errors measured over the domains used by the solver:
+*
+*	Function		| double (ULP)	| float (ULP)
+*	acos(x), |x| <= 1	| 2		| 2
+*	sincos(x), |x| <= pi/3	| 2		| 3
+*	cbrt(x)			| 1		| 1
+*
+* Errors of sincos() are measured in ULP of max(|sin(x)|, |cos(x)|) as the solver combines both terms.
+*
+* Provided under the Unlicense License (public domain, see license terms at http://unlicense.org/).
+*/
+#include<cmath>
+#include<cstdint>
+#include<cstring>
+#include<limits>
+#include<type_traits>
+
+
+namespace fast {
+
+	template<typename FP>
+	inline FP horner(FP z, const FP* c, int n)
+	{
+		FP p = c[n - 1];
+		for (int i = n - 2; i >= 0; i--) {
+			p = p * z + c[i];
+		}
+		return p;
+	}
+
+	/**
+	* asin(x) for |x| <= 0.5 evaluated as x + x z R(z), z = x^2.
+	*/
+	template<typename FP>
+	inline FP asin_reduced(FP x)
+	{
+		FP z = x * x;
+		if constexpr (std::is_same<float, typename std::remove_cv<FP>::type>::value) {
+			constexpr float R[] = {
+				0.166666724147953052216f, 0.074988550726008198718f, 0.0450013800699104127269f,
+				0.026554542206159809093f, 0.0380850235610955767398f };
+			return x + x * z * horner(z, R, 5);
+		}
+		else {
+			constexpr FP R[] = {
+				(FP)0.166666666666666486436, (FP)0.0750000000002075608931, (FP)0.0446428571034338683014,
+				(FP)0.0303819473665698046063, (FP)0.0223720476460313455486, (FP)0.0173552597280622518862,
+				(FP)0.0139296551870558005248, (FP)0.0118754795206162574069, (FP)0.0078030121864382332823,
+				(FP)0.0160353484388906508684, (FP)-0.0107487998902797698958, (FP)0.0281690532962481180821 };
+			return x + x * z * horner(z, R, 12);
+		}
+	}
+
+	/**
+	* Arc cosine for |x| <= 1 using the reduction acos(x) = 2 asin(sqrt((1 - |x|) / 2)) for |x| > 0.5.
+	*/
+	template<typename FP>
+	inline FP acos(FP x)
+	{
+		constexpr FP PI = (FP)3.141592653589793238462643383279502884197169399375105820974944592307816406286;
+		if (std::abs(x) <= (FP)0.5) {
+			return PI * (FP)0.5 - asin_reduced(x);
+		}
+		FP s = (FP)2.0 * asin_reduced(std::sqrt(((FP)1.0 - std::abs(x)) * (FP)0.5));
+		return x > (FP)0.0 ? s : PI - s;
+	}
+
+	/**
+	* Sine and cosine for |x| <= pi / 3 evaluated as s = x S(z), c = C(z), z = x^2.
+	*/
+	template<typename FP>
+	inline void sincos(FP x, FP& s, FP& c)
+	{
+		FP z = x * x;
+		if constexpr (std::is_same<float, typename std::remove_cv<FP>::type>::value) {
+			constexpr float S[] = {
+				0.999999969479327700361f, -0.166665775779062467872f, 0.00832926449943262470125f,
+				-0.000192450867404686567426f };
+			constexpr float C[] = {
+				0.999999999163958560146f, -0.499999961874711313156f, 0.0416663882939107761049f,
+				-0.0013881767427422982861f, 2.40562047900249141137e-05f };
+			s = x * horner(z, S, 4);
+			c = horner(z, C, 5);
+		}
+		else {
+			constexpr FP S[] = {
+				(FP)1.00000000000000000043, (FP)-0.166666666666666683802, (FP)0.00833333333333331656163,
+				(FP)-0.000198412698411335422019, (FP)2.75573191508295721623e-06, (FP)-2.50520913996180569369e-08,
+				(FP)1.6057034696518026793e-10, (FP)-7.52821589335329934404e-13 };
+			constexpr FP C[] = {
+				(FP)0.999999999999999997669, (FP)-0.499999999999999682275, (FP)0.0416666666666602540151,
+				(FP)-0.00138888888884101762868, (FP)2.48015871279994652824e-05, (FP)-2.75572852113962547872e-07,
+				(FP)2.08730733759953181702e-09, (FP)-1.1263057955317918308e-11 };
+			s = x * horner(z, S, 8);
+			c = horner(z, C, 8);
+		}
+	}
+
+	/**
+	* Cube root from an exponent-division initial guess (relative error < 3.3%) refined by Halley iterations
+	* (two for double, one for float) and a final Newton step, which takes the double result from 40 to 1 ULP for
+	* about 1 ns. Corrections are formed as relative updates (no under- / overflow over the normal range), subnormal
+	* and very large (> max / 4) input falls back to std::cbrt().
+	*/
+	template<typename FP>
+	inline FP cbrt(FP x)
+	{
+		FP a = std::abs(x);
+		if (!(a >= std::numeric_limits<FP>::min()) || !(a <= std::numeric_limits<FP>::max() / (FP)4.0)) {
+			return std::cbrt(x);
+		}
+		FP r, r3;
+		if constexpr (std::is_same<float, typename std::remove_cv<FP>::type>::value) {
+			std::uint32_t i;
+			std::memcpy(&i, &a, sizeof(float));
+			i = i / 3 + 0x2A5119F2u;
+			std::memcpy(&r, &i, sizeof(float));
+			r3 = r * r * r;
+			r += r * ((a - r3) / ((FP)2.0 * r3 + a));
+			r -= (r * r * r - a) / ((FP)3.0 * r * r);
+		}
+		else {
+			static_assert(sizeof(FP) == sizeof(std::uint64_t), "fast::cbrt() requires an IEEE-754 double or float.");
+			std::uint64_t i;
+			std::memcpy(&i, &a, sizeof(FP));
+			i = i / 3 + 0x2A9F7893782DA1CEull;
+			std::memcpy(&r, &i, sizeof(FP));
+			r3 = r * r * r;
+			r += r * ((a - r3) / ((FP)2.0 * r3 + a));
+			r3 = r * r * r;
+			r += r * ((a - r3) / ((FP)2.0 * r3 + a));
+			r -= (r * r * r - a) / ((FP)3.0 * r * r);
+		}
+		return std::copysign(r, x);
+	}
+}
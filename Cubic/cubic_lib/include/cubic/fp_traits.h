@@ -0,0 +1,44 @@
+#pragma once
+/* Type-correct floating point constants for the types the solvers are instantiated for.
+*
+* The solvers are instantiated for float, double and long double. If CUBIC_FLOAT128 is defined (GCC / Clang with
+* libquadmath, see the CUBIC_FLOAT128 CMake option) they are also instantiated for __float128, and the <cmath>
+* functions used by the solvers are overloaded for __float128 in the global namespace using <quadmath.h>.
+*
+* Provided under the Unlicense License (public domain, see license terms at http://unlicense.org/).
+*/
+#include<limits>
+#ifdef CUBIC_FLOAT128
+#include<quadmath.h>
+#endif
+
+
+template<typename FP>
+struct fp_traits {
+	static constexpr FP epsilon = std::numeric_limits<FP>::epsilon();
+	static constexpr FP pi = (FP)3.141592653589793238462643383279502884197169399375105820974944592307816406286L;
+};
+
+#ifdef CUBIC_FLOAT128
+template<>
+struct fp_traits<__float128> {
+	/* Built from double constants, the Q literal suffix requires GNU extensions (-std=gnu++17). */
+	static constexpr __float128 epsilon = (__float128)0x1p-56 * (__float128)0x1p-56;
+	static constexpr __float128 pi = ((__float128)0x1.921fb54442d18p+1 + (__float128)0x1.1a62633145c07p-53)
+		+ (__float128)-0x1.f1976b7ed8fbcp-109;
+};
+
+inline __float128 sqrt(__float128 x) { return sqrtq(x); }
+inline __float128 cbrt(__float128 x) { return cbrtq(x); }
+inline __float128 acos(__float128 x) { return acosq(x); }
+inline __float128 cos(__float128 x) { return cosq(x); }
+inline __float128 fabs(__float128 x) { return fabsq(x); }
+inline __float128 copysign(__float128 x, __float128 y) { return copysignq(x, y); }
+inline __float128 fmax(__float128 x, __float128 y) { return fmaxq(x, y); }
+inline __float128 fmin(__float128 x, __float128 y) { return fminq(x, y); }
+inline __float128 fma(__float128 x, __float128 y, __float128 z) { return fmaq(x, y, z); }
+#ifdef __STRICT_ANSI__
+/* Provided as std::abs(__float128) by libstdc++ in GNU mode (-std=gnu++17). */
+inline __float128 abs(__float128 x) { return fabsq(x); }
+#endif
+#endif
@@ -0,0 +1,97 @@
+#pragma once
+/* Fused grid -> coefficient -> solve -> reduce pipeline for parameter sweeps over cubic equations.
+*
+* Provided under the Unlicense License (public domain, see license terms at http://unlicense.org/).
+*/
+#include "cubic/aligned_buffer.h"
+#include "cubic/cubic.h"
+#include "cubic/ndgrid.h"
+
+#include<algorithm>
+#include<array>
+#include<cstdint>
+
+
+/**
+ * Grid points processed per tile in 'cubic_roots_grid_reduce()'. The coordinates, coefficients and roots of a tile
+ * of double equations occupy about 2048 * (4 + 4 + 3) * 8 bytes = 176 kB and stay resident in L2.
+ */
+constexpr std::int64_t GRID_TILE_SIZE = 2048;
+
+/**
+ * Solve the cubic equations of a parameter sweep and reduce the result, without materializing the grid, the
+ * coefficients or the roots.
+ *
+ * The grid is processed in tiles of tile_size points, in parallel over tiles. For each tile the coordinates are
+ * generated ('NdgridView::fill()'), mapped to coefficients by
+ *
+ *		coeff(const FP* point, FP* A)		writing [a, b, c, d] of the equation at the grid point (ndim coordinates),
+ *
+ * solved by 'solver' and reduced into a per thread copy of 'init' by
+ *
+ *		accumulate(R& acc, std::int64_t index, const FP* A, const FP* xroots, int nroots)
+ *
+ * where index is the grid point index. The per thread results are merged into another copy of 'init' by
+ * combine(R& acc, const R& other) in an unspecified order, which should therefore be associative and commutative.
+ * As 'init' enters the result once per thread plus once, it must be the identity of combine (e.g. zero counts or
+ * an empty histogram), as for an OpenMP reduction. Buffers are allocated once per thread, memory use is
+ * O(num_threads * tile_size) independent of the grid size.
+ *
+ * Tiles are processed in parallel only if the including translation unit is compiled with OpenMP, the static
+ * library target propagates it to its consumers (OpenMP::OpenMP_CXX is a public dependency).
+ *
+ * Returns the reduced result.
+ */
+template<typename FP, std::int64_t ndim, typename R, typename CoeffFunc, typename Accumulate, typename Combine>
+R cubic_roots_grid_reduce(const NdgridView<FP, ndim>& grid, CoeffFunc coeff, R init, Accumulate accumulate, Combine combine,
+	std::int64_t tile_size = GRID_TILE_SIZE, CBRT_SOLVER<FP> solver = &cubic_roots<FP>)
+{
+	tile_size = std::max<std::int64_t>(1, std::min(tile_size, grid.size()));
+	const std::int64_t ntiles = grid.num_chunks(tile_size);
+	R result = init;
+#pragma omp parallel if(ntiles > 1)
+	{
+		/* Thread local, first touched by the owning thread. */
+		AlignedBuffer<FP> coords(ndim * tile_size), coeffs(4 * tile_size), xroots(3 * tile_size);
+		AlignedBuffer<int> nroots(tile_size);
+		R local = init;
+#pragma omp for schedule(static)
+		for (std::int64_t k = 0; k < ntiles; k++) {
+			const IndexRange points = grid.chunk(k, tile_size);
+			grid.fill(points, coords.data());
+			for (std::int64_t j = 0; j < points.size(); j++) {
+				coeff(static_cast<const FP*>(coords.data() + ndim * j), coeffs.data() + 4 * j);
+			}
+			for (std::int64_t j = 0; j < points.size(); j++) {
+				const FP* A = coeffs.data() + 4 * j;
+				nroots[j] = solver(A[0], A[1], A[2], A[3], xroots.data() + 3 * j);
+			}
+			for (std::int64_t j = 0; j < points.size(); j++) {
+				accumulate(local, points[j], static_cast<const FP*>(coeffs.data() + 4 * j),
+					static_cast<const FP*>(xroots.data() + 3 * j), nroots[j]);
+			}
+		}
+#pragma omp critical(cubic_roots_grid_reduce)
+		combine(result, static_cast<const R&>(local));
+	}
+	return result;
+}
+
+/**
+ * Count the equations of a parameter sweep by number of real roots, count[n] is the number of grid points where
+ * the equation coeff(point) has n real roots (see 'cubic_roots_grid_reduce()').
+ */
+template<typename FP, std::int64_t ndim, typename CoeffFunc>
+std::array<std::int64_t, 4> cubic_root_counts_grid(const NdgridView<FP, ndim>& grid, CoeffFunc coeff,
+	std::int64_t tile_size = GRID_TILE_SIZE, CBRT_SOLVER<FP> solver = &cubic_roots<FP>)
+{
+	typedef std::array<std::int64_t, 4> Counts;
+	return cubic_roots_grid_reduce(grid, coeff, Counts{ 0, 0, 0, 0 },
+		[](Counts& acc, std::int64_t, const FP*, const FP*, int n) { acc[n]++; },
+		[](Counts& acc, const Counts& other) {
+			for (int n = 0; n < 4; n++) {
+				acc[n] += other[n];
+			}
+		},
+		tile_size, solver);
+}
@@ -0,0 +1,283 @@
+#pragma once
+/* Coordinates of regular N-dimensional grids.
+*
+* Provided under the Unlicense License (public domain, see license terms at http://unlicense.org/).
+*/
+#include "cubic/IndexRange.h"
+#include "cubic/aligned_buffer.h"
+
+#include<algorithm>
+#include<array>
+#include<assert.h>
+#include<cstdint>
+#include<cstdlib>
+#include<utility>
+
+
+/**
+ * Lazy view of a regular grid with shape[i] points along dimension i, spanning size[i] and centered on the origin.
+ *
+ * Coordinates are an affine function of the point index and are computed on access, nothing is stored. Points are
+ * indexed row-major (last dimension varying fastest) as for 'ndgrid()', which materializes the whole view. Large
+ * grids are traversed in chunks (sub-ranges of 'range()') by 'fill()' or 'for_each_chunk()' into a caller supplied
+ * buffer of ndim * chunk_size values, keeping memory use independent of the grid size.
+ */
+template <typename FP, std::int64_t ndim>
+class NdgridView {
+	static_assert(ndim > 1, "Grid must have at least 2 dimensions.");
+public:
+	NdgridView(const std::array<std::int64_t, ndim>& shape, const std::array<FP, ndim>& size)
+		: m_shape(shape), m_size(1)
+	{
+		for (std::int64_t i = 0; i < ndim; i++) {
+			m_size *= shape[i];
+			std::int64_t shn1 = shape[i] - 1;
+			m_delta[i] = shn1 == 0 ? FP(0) : size[i] / shn1;
+			m_shift[i] = shn1 / FP(2);
+		}
+		m_sh_prod[ndim - 1] = 1;
+		for (std::int64_t i = ndim - 1; i >= 1; i--) {
+			m_sh_prod[i - 1] = m_sh_prod[i] * shape[i];
+		}
+	}
+
+	/* Number of points in the grid. */
+	std::int64_t size() const { return m_size; }
+	/* Range of the point indices. */
+	IndexRange range() const { return IndexRange(m_size); }
+	const std::array<std::int64_t, ndim>& shape() const { return m_shape; }
+	/* Number of points spanned by an index step along each dimension. */
+	const std::array<std::int64_t, ndim>& strides() const { return m_sh_prod; }
+
+	/* Coordinate of index 'index' along dimension 'dim'. */
+	FP coordinate(std::int64_t dim, std::int64_t index) const
+	{
+		return (index - m_shift[dim]) * m_delta[dim];
+	}
+
+	/* Coordinates of point j. */
+	std::array<FP, ndim> operator[](std::int64_t j) const
+	{
+		assert(j >= 0 && j < m_size);
+		std::array<FP, ndim> values;
+		std::lldiv_t dv = { 0, j };
+		for (std::int64_t i = 0; i < ndim; i++) {
+			dv = std::lldiv(dv.rem, m_sh_prod[i]);
+			values[i] = coordinate(i, dv.quot);
+		}
+		return values;
+	}
+
+	/**
+	 * Write the coordinates of the points in 'points' interleaved to out[ndim * points.size()]. Indices of the first
+	 * point are reconstructed by division, remaining points are stepped to row by row.
+	 */
+	void fill(IndexRange points, FP* out) const
+	{
+		if (points.size() == 0) {
+			return;
+		}
+		assert(points.one_after_last() <= m_size);
+		std::array<std::int64_t, ndim> index;
+		std::array<FP, ndim> values;
+		std::lldiv_t dv = { 0, points.start() };
+		for (std::int64_t i = 0; i < ndim; i++) {
+			dv = std::lldiv(dv.rem, m_sh_prod[i]);
+			index[i] = dv.quot;
+			values[i] = coordinate(i, dv.quot);
+		}
+		const std::int64_t ncol = m_shape[ndim - 1];
+		std::int64_t remaining = points.size();
+		while (true) {
+			/* Iterate over (the rest of) the row and assign. */
+			const std::int64_t n = std::min(ncol - index[ndim - 1], remaining);
+			for (std::int64_t j = index[ndim - 1]; j < index[ndim - 1] + n; j++) {
+				for (std::int64_t i = 0; i < ndim - 1; i++) {
+					out[i] = values[i];
+				}
+				out[ndim - 1] = coordinate(ndim - 1, j);
+				out += ndim;
+			}
+			remaining -= n;
+			if (remaining == 0) {
+				break;
+			}
+			/* Step to the next row, carrying over to the preceding dimensions. */
+			index[ndim - 1] = 0;
+			for (std::int64_t i = ndim - 2; i >= 0; i--) {
+				if (++index[i] < m_shape[i]) {
+					values[i] = coordinate(i, index[i]);
+					break;
+				}
+				index[i] = 0;
+				values[i] = coordinate(i, 0);
+			}
+		}
+	}
+
+	/**
+	 * Write coordinate 'dim' of the points in 'points' to out[points.size()] (one plane of the structure-of-arrays
+	 * layout). The plane is constant over runs of strides()[dim] points and repeats with a period of
+	 * shape()[dim] * strides()[dim] points: the first period is written by broadcasting each run, the rest is copied
+	 * from the preceding periods.
+	 */
+	void fill_plane(std::int64_t dim, IndexRange points, FP* out) const
+	{
+		if (points.size() == 0) {
+			return;
+		}
+		assert(points.one_after_last() <= m_size);
+		const std::int64_t run = m_sh_prod[dim], period = run * m_shape[dim];
+		const std::int64_t first = std::min(period, points.size());
+		const std::lldiv_t dv = std::lldiv(points.start(), run);
+		std::int64_t index = dv.quot % m_shape[dim], offset = dv.rem;
+		for (std::int64_t j = 0; j < first;) {
+			if (run == 1) {
+				/* Consecutive indices up to the end of the dimension. */
+				const std::int64_t n = std::min(m_shape[dim] - index, first - j);
+				for (std::int64_t k = 0; k < n; k++) {
+					out[j + k] = coordinate(dim, index + k);
+				}
+				j += n;
+				index = 0;
+				continue;
+			}
+			const std::int64_t n = std::min(run - offset, first - j);
+			std::fill_n(out + j, n, coordinate(dim, index));
+			j += n;
+			offset = 0;
+			if (++index == m_shape[dim]) {
+				index = 0;
+			}
+		}
+		/* Replicate whole periods, doubling the copied block. */
+		for (std::int64_t filled = first; filled < points.size();) {
+			const std::int64_t n = std::min(filled / period * period, points.size() - filled);
+			std::copy_n(out, n, out + filled);
+			filled += n;
+		}
+	}
+
+	/**
+	 * Write the coordinates of the points in 'points' as separate planes, coordinate i of the j:th point to
+	 * out[i * plane_stride + j] (plane_stride >= points.size()).
+	 */
+	void fill_planes(IndexRange points, FP* out, std::int64_t plane_stride) const
+	{
+		assert(plane_stride >= points.size());
+		for (std::int64_t i = 0; i < ndim; i++) {
+			fill_plane(i, points, out + i * plane_stride);
+		}
+	}
+
+	/* Range of the k:th chunk of chunk_size points, the last chunk may be smaller. */
+	IndexRange chunk(std::int64_t k, std::int64_t chunk_size) const
+	{
+		const std::int64_t start = k * chunk_size;
+		return IndexRange(start, std::min(chunk_size, m_size - start));
+	}
+
+	/* Number of chunks of chunk_size points covering the grid. */
+	std::int64_t num_chunks(std::int64_t chunk_size) const
+	{
+		return (m_size + chunk_size - 1) / chunk_size;
+	}
+
+	/**
+	 * Iterate over the grid in chunks of chunk_size points: the coordinates of each chunk are written to
+	 * buffer[ndim * chunk_size] and f(IndexRange chunk, const FP* coords) is called.
+	 */
+	template <typename Func>
+	void for_each_chunk(std::int64_t chunk_size, FP* buffer, Func f) const
+	{
+		for (std::int64_t k = 0; k < num_chunks(chunk_size); k++) {
+			const IndexRange points = chunk(k, chunk_size);
+			fill(points, buffer);
+			f(points, static_cast<const FP*>(buffer));
+		}
+	}
+
+private:
+	std::array<std::int64_t, ndim> m_shape;
+	std::array<std::int64_t, ndim> m_sh_prod;
+	std::array<FP, ndim> m_delta;
+	std::array<FP, ndim> m_shift;
+	std::int64_t m_size;
+};
+
+/**
+ * Strategy used to fill the grid, see 'grid_bench' for the timings they are chosen from.
+ *
+ *	AUTO			Choose from the shape and the number of (OpenMP) threads.
+ *	ROWS			Fill row by row (runs along the last dimension) on the calling thread.
+ *	SLICE_COPY		Fill the first slice (index 0 along the first dimension) and copy it to the remaining slices,
+ *					overwriting the first coordinate. Slices are copied in parallel.
+ *	PARALLEL_TILES	Fill in parallel over the flattened point index, partitioned in cache line aligned tiles. Each
+ *					thread reconstructs the coordinates of its first point and streams the rest.
+ */
+enum class NdgridStrategy {
+	AUTO,
+	ROWS,
+	SLICE_COPY,
+	PARALLEL_TILES,
+};
+
+/**
+ * Generate the coordinates of a regular grid with shape[i] points along dimension i, spanning size[i] and centered
+ * on the origin: the coordinate of index j along dimension i is (j - (shape[i] - 1) / 2) * size[i] / (shape[i] - 1).
+ *
+ * Points are stored row-major (last dimension varying fastest) with interleaved coordinates, the i:th coordinate
+ * of point j is data[ndim * j + i]. The returned buffer holds ndim * prod(shape) values, allocated by 'alloc'. The
+ * buffer is not initialized before it is filled, pages are first touched by the threads filling them (unless
+ * 'AllocConfig::first_touch_items' is set). Instantiated for float and double with ndim 2, 3 and 4.
+ */
+template <typename FP = double, std::int64_t ndim>
+AlignedBuffer<FP> ndgrid(std::array<std::int64_t, ndim> shape, std::array<FP, ndim> size,
+	NdgridStrategy strategy = NdgridStrategy::AUTO, const AllocConfig& alloc = AllocConfig());
+
+/**
+ * Materialize the grid view, same as 'ndgrid(shape, size, strategy, alloc)'.
+ */
+template <typename FP = double, std::int64_t ndim>
+AlignedBuffer<FP> ndgrid(const NdgridView<FP, ndim>& grid, NdgridStrategy strategy = NdgridStrategy::AUTO,
+	const AllocConfig& alloc = AllocConfig());
+
+/**
+ * Grid coordinates in structure-of-arrays layout, coordinate i of point j is plane(i)[j]. Planes are stored in one
+ * buffer 'stride()' values apart, each plane starts on a cache line boundary.
+ */
+template <typename FP, std::int64_t ndim>
+class NdgridPlanes {
+public:
+	NdgridPlanes(AlignedBuffer<FP>&& buffer, std::int64_t npoints, std::int64_t stride)
+		: m_buffer(std::move(buffer)), m_size(npoints), m_stride(stride)
+	{
+	}
+
+	/* Number of points in the grid. */
+	std::int64_t size() const { return m_size; }
+	/* Distance in values between consecutive planes. */
+	std::int64_t stride() const { return m_stride; }
+
+	FP* plane(std::int64_t dim) { return m_buffer.data() + dim * m_stride; }
+	const FP* plane(std::int64_t dim) const { return m_buffer.data() + dim * m_stride; }
+
+	const AlignedBuffer<FP>& buffer() const { return m_buffer; }
+
+private:
+	AlignedBuffer<FP> m_buffer;
+	std::int64_t m_size;
+	std::int64_t m_stride;
+};
+
+/**
+ * Generate the grid of 'ndgrid()' in structure-of-arrays layout (one plane per dimension), ready for SIMD consumers
+ * without transposing. Each plane is filled by 'NdgridView::fill_plane()', in parallel over cache line aligned
+ * ranges of the points for large grids. Instantiated for float and double with ndim 2, 3 and 4.
+ */
+template <typename FP = double, std::int64_t ndim>
+NdgridPlanes<FP, ndim> ndgrid_planes(const NdgridView<FP, ndim>& grid, const AllocConfig& alloc = AllocConfig());
+
+template <typename FP = double, std::int64_t ndim>
+NdgridPlanes<FP, ndim> ndgrid_planes(std::array<std::int64_t, ndim> shape, std::array<FP, ndim> size,
+	const AllocConfig& alloc = AllocConfig());
@@ -0,0 +1,41 @@
+#pragma once
+/* Batch evaluation of cubic and quadratic polynomials.
+*
+* Polynomials are evaluated by Horner's scheme using fused multiply-add if the target supports it in hardware
+* (FP_FAST_FMA, __FMA__ or __AVX2__), loops are vectorized with OpenMP simd and split over threads for large N.
+* If df is not null the derivative is evaluated in the same pass (fused Horner). The compensated variant evaluates
+* f(x) as accurately as if computed in twice the working precision (see 'eft.h'), the derivative is always
+* evaluated in working precision.
+*
+* Provided under the Unlicense License (public domain, see license terms at http://unlicense.org/).
+*/
+#include<cstdint>
+
+
+/**
+ * Evaluate f_i = a_i x_i^3 + b_i x_i^2 + c_i x_i + d_i for i < N, coefficients and points stored as SoA (separate
+ * arrays). If df is not null the derivative f'(x_i) is written to df[i].
+ */
+template<typename FP>
+void cubic_eval_soa(const FP* a, const FP* b, const FP* c, const FP* d, const FP* x, std::int64_t N, FP* f, FP* df = nullptr, bool compensated = false);
+
+/**
+ * Evaluate f_i = a x_i^3 + b x_i^2 + c x_i + d for the single cubic polynomial at N points. If df is not null the
+ * derivative f'(x_i) is written to df[i].
+ */
+template<typename FP>
+void cubic_eval_points(FP a, FP b, FP c, FP d, const FP* x, std::int64_t N, FP* f, FP* df = nullptr, bool compensated = false);
+
+/**
+ * Evaluate f_i = a_i x_i^2 + b_i x_i + c_i for i < N, coefficients and points stored as SoA (separate arrays).
+ * If df is not null the derivative f'(x_i) is written to df[i].
+ */
+template<typename FP>
+void quadratic_eval_soa(const FP* a, const FP* b, const FP* c, const FP* x, std::int64_t N, FP* f, FP* df = nullptr, bool compensated = false);
+
+/**
+ * Evaluate f_i = a x_i^2 + b x_i + c for the single quadratic polynomial at N points. If df is not null the
+ * derivative f'(x_i) is written to df[i].
+ */
+template<typename FP>
+void quadratic_eval_points(FP a, FP b, FP c, const FP* x, std::int64_t N, FP* f, FP* df = nullptr, bool compensated = false);
@@ -0,0 +1,77 @@
+/* Aligned, optionally huge page backed, owning buffers for grids and batch solver input / output.
+*
+* Provided under the Unlicense License (public domain, see license terms at http://unlicense.org/).
+*/
+#include "cubic/aligned_buffer.h"
+
+#include<algorithm>
+#include<cstdlib>
+#include<cstring>
+#include<new>
+
+#ifdef _WIN32
+#include<malloc.h>
+#else
+#include<sys/mman.h>
+#endif
+
+
+void* aligned_allocate(std::size_t bytes, const AllocConfig& config)
+{
+	const std::size_t alignment = config.huge_pages ? std::max(config.alignment, HUGE_PAGE_SIZE) : config.alignment;
+	/* Zero sized allocations still return a unique pointer. */
+	bytes = std::max<std::size_t>(bytes, 1);
+#ifdef _WIN32
+	void* ptr = _aligned_malloc(bytes, alignment);
+	if (!ptr) {
+		throw std::bad_alloc();
+	}
+#else
+	void* ptr = nullptr;
+	if (posix_memalign(&ptr, std::max(alignment, sizeof(void*)), bytes) != 0) {
+		throw std::bad_alloc();
+	}
+#ifdef MADV_HUGEPAGE
+	if (config.huge_pages) {
+		/* Advisory only, transparent huge pages may be disabled. Only whole huge pages within the allocation are
+		 * advised, the range is rounded down as memory past the end is owned by the heap. */
+		const std::size_t advised = bytes / HUGE_PAGE_SIZE * HUGE_PAGE_SIZE;
+		if (advised > 0) {
+			madvise(ptr, advised, MADV_HUGEPAGE);
+		}
+	}
+#endif
+#endif
+	return ptr;
+}
+
+void aligned_deallocate(void* ptr)
+{
+#ifdef _WIN32
+	_aligned_free(ptr);
+#else
+	std::free(ptr);
+#endif
+}
+
+void first_touch(void* bytes, std::size_t size, std::int64_t nitems)
+{
+	char* data = static_cast<char*>(bytes);
+#pragma omp parallel
+	{
+		/* Items assigned to this thread by the static schedule, contiguous [first, last]. */
+		std::int64_t first = -1, last = -1;
+#pragma omp for schedule(static)
+		for (std::int64_t i = 0; i < nitems; i++) {
+			if (first < 0) {
+				first = i;
+			}
+			last = i;
+		}
+		if (first >= 0) {
+			const std::size_t begin = (std::size_t)((double)first / nitems * size);
+			const std::size_t end = last + 1 == nitems ? size : (std::size_t)((double)(last + 1) / nitems * size);
+			std::memset(data + begin, 0, end - begin);
+		}
+	}
+}
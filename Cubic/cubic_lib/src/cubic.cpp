@@ -25,6 +25,8 @@ OTHER DEALINGS IN THE SOFTWARE.
 For more information, please refer to <http://unlicense.org/>
 */
 #include "cubic/cubic.h"
+#include "cubic/fp_traits.h"
+#include "cubic_kernels.h"
 #include <math.h>
 #include <cmath>
 #include <float.h>
@@ -37,6 +39,10 @@ FP quadratic(FP a, FP b, FP c, FP x)
 }
 template double quadratic(double a, double b, double c, double x);
 template float quadratic(float a, float b, float c, float x);
+template long double quadratic(long double a, long double b, long double c, long double x);
+#ifdef CUBIC_FLOAT128
+template __float128 quadratic(__float128 a, __float128 b, __float128 c, __float128 x);
+#endif
 
 template<typename FP>
 FP cubic(FP a, FP b, FP c, FP d, FP x)
@@ -46,6 +52,10 @@ FP cubic(FP a, FP b, FP c, FP d, FP x)
 }
 template double cubic(double a, double b, double c, double d, double x);
 template float cubic(float a, float b, float c, float d, float x);
+template long double cubic(long double a, long double b, long double c, long double d, long double x);
+#ifdef CUBIC_FLOAT128
+template __float128 cubic(__float128 a, __float128 b, __float128 c, __float128 d, __float128 x);
+#endif
 
 /**
 * Find the roots to the quadratic equation
@@ -56,7 +66,7 @@ template float cubic(float a, float b, float c, float d, float x);
 template<typename FP>
 int quadratic_roots(FP a, FP b, FP c, FP* xroots) {
 	using namespace std;
-	constexpr FP EPSILON = is_same<float, typename remove_cv<FP>::type>::value ? FLT_EPSILON : DBL_EPSILON;
+	constexpr FP EPSILON = fp_traits<FP>::epsilon;
 
 	if (abs(a) < EPSILON)
 	{
@@ -100,6 +110,10 @@ int quadratic_roots(FP a, FP b, FP c, FP* xroots) {
 }
 template int quadratic_roots(double a, double b, double c, double* xroots);
 template int quadratic_roots(float a, float b, float c, float* xroots);
+template int quadratic_roots(long double a, long double b, long double c, long double* xroots);
+#ifdef CUBIC_FLOAT128
+template int quadratic_roots(__float128 a, __float128 b, __float128 c, __float128* xroots);
+#endif
 
 /**
  * Implementation uses both the trignometric and Cardano's method method for solving cubic equations.
@@ -109,17 +123,13 @@ template int quadratic_roots(float a, float b, float c, float* xroots);
  * @date      2011 (cloned Nov 2021)
  * @copyright unlicense / public domain
  ****************************************************************************/
-template<typename FP>
-int cubic_roots(FP a, FP b, FP c, FP d, FP* xroots)
+template<typename FP, bool FAST>
+inline int cubic_roots_impl(FP a, FP b, FP c, FP d, FP* xroots)
 {
 	using namespace std;
-	constexpr FP PI = (FP)3.141592653589793238462643383279502884197169399375105820974944592307816406286;
-	constexpr FP PIHalf = (FP)(PI / 2.0);
-	constexpr FP PI2 = (FP)(PI * 2.0);
-	constexpr FP PI2over3 = (FP)(PI * 2.0 / 3.0);
-	constexpr FP third = (FP)(1.0 / 3.0);
+	constexpr FP third = (FP)1.0 / (FP)3.0;
 	constexpr FP zero = (FP)0.0;
-	constexpr FP EPSILON = is_same<float, typename remove_cv<FP>::type>::value ? FLT_EPSILON : DBL_EPSILON;
+	constexpr FP EPSILON = fp_traits<FP>::epsilon;
 
 	int n = 0;
 	if (abs(d) < EPSILON)
@@ -138,58 +148,109 @@ int cubic_roots(FP a, FP b, FP c, FP d, FP* xroots)
 	{
 		return quadratic_roots<FP>(b, c, d, xroots) + n;
 	}
-	else
-
-		/* Cubic equation */ {
-		/* Reduce form through division, multiplication of '1.0 / a' has a (small) precision cost. */
-		b = b / a;
-		c = c / a;
-		d = d / a;
-		//a = (FP)1.0;
 
-		FP bover3 = b * third;
-		FP p = c - bover3 * b;
-		FP halfq = bover3 * bover3 * bover3 - (FP)0.5 * bover3 * c + (FP)0.5 * d;
-		FP yy = p / (FP)27.0 * p * p + halfq * halfq;
+	/* Cubic equation */
+	/* Reduce form through division, multiplication of '1.0 / a' has a (small) precision cost. */
+	b = b / a;
+	c = c / a;
+	d = d / a;
+	//a = (FP)1.0;
 
-		if (yy < (FP)0.0) /* Sqrt is negative: three real solutions */
-		{
-			n = 3;
-			if (fabs(p) < EPSILON)
-			{
-				xroots[0] = -bover3;
-				xroots[1] = xroots[0];
-				xroots[2] = xroots[0];
-			}
-			else
-			{
-				FP uu = (FP)(-4.0 / 3.0) * p;
-				FP u = sqrt(uu);
-				FP theta = acos((FP)-8.0 * halfq / (u * uu)) * third;
-				xroots[0] = u * cos(theta) - bover3;
-				xroots[1] = u * cos(theta - PI2over3) - bover3;
-				xroots[2] = u * cos(theta + PI2over3) - bover3;
-			}
-		}
-		else
-		{
-			/*  Sqrt is positive: one real solution */
-			FP y = sqrt(yy);
-			FP uuu = y - halfq;
-			FP vvv = -y - halfq;
-			FP www = abs(uuu) > abs(vvv) ? uuu : vvv;
-			FP w = copysign(cbrt(abs(www)), www);
-			*xroots = w - p / ((FP)3.0 * w) - bover3;
-			n = 1;
-			return n;
-		}
-		return n;
-	}
+	FP bover3 = b * third;
+	FP p = c - bover3 * b;
+	FP halfq = bover3 * bover3 * bover3 - (FP)0.5 * bover3 * c + (FP)0.5 * d;
+	return depressed_roots<FP, FAST>(p, halfq, bover3, xroots);
+}
 
-	return n;
+template<typename FP>
+int cubic_roots(FP a, FP b, FP c, FP d, FP* xroots)
+{
+	return cubic_roots_impl<FP, false>(a, b, c, d, xroots);
 }
 template int cubic_roots(double a, double b, double c, double d, double* xroots);
 template int cubic_roots(float a, float b, float c, float d, float* xroots);
+template int cubic_roots(long double a, long double b, long double c, long double d, long double* xroots);
+#ifdef CUBIC_FLOAT128
+template int cubic_roots(__float128 a, __float128 b, __float128 c, __float128 d, __float128* xroots);
+#endif
+
+template<typename FP>
+int cubic_roots_fast(FP a, FP b, FP c, FP d, FP* xroots)
+{
+	return cubic_roots_impl<FP, true>(a, b, c, d, xroots);
+}
+template int cubic_roots_fast(double a, double b, double c, double d, double* xroots);
+template int cubic_roots_fast(float a, float b, float c, float d, float* xroots);
+
+/**
+ * Same as 'cubic_roots()' for a = 1, skipping the reduction (division) step.
+ */
+template<typename FP>
+int monic_cubic_roots(FP b, FP c, FP d, FP* xroots)
+{
+	using namespace std;
+	constexpr FP third = (FP)1.0 / (FP)3.0;
+	constexpr FP EPSILON = fp_traits<FP>::epsilon;
+
+	if (abs(d) < EPSILON)
+	{
+		/* First solution is x = 0, divide all terms by x converting to quadratic equation */
+		*xroots = (FP)0.0;
+		return quadratic_roots<FP>((FP)1.0, b, c, xroots + 1) + 1;
+	}
+
+	FP bover3 = b * third;
+	FP p = c - bover3 * b;
+	FP halfq = bover3 * bover3 * bover3 - (FP)0.5 * bover3 * c + (FP)0.5 * d;
+	return depressed_roots(p, halfq, bover3, xroots);
+}
+template int monic_cubic_roots(double b, double c, double d, double* xroots);
+template int monic_cubic_roots(float b, float c, float d, float* xroots);
+template int monic_cubic_roots(long double b, long double c, long double d, long double* xroots);
+#ifdef CUBIC_FLOAT128
+template int monic_cubic_roots(__float128 b, __float128 c, __float128 d, __float128* xroots);
+#endif
+
+/**
+ * Same as 'cubic_roots()' for a = 1, b = 0, skipping the reduction and depression steps.
+ */
+template<typename FP>
+int depressed_cubic_roots(FP p, FP q, FP* xroots)
+{
+	using namespace std;
+	constexpr FP EPSILON = fp_traits<FP>::epsilon;
+
+	if (abs(q) < EPSILON)
+	{
+		/* First solution is x = 0, divide all terms by x converting to quadratic equation */
+		*xroots = (FP)0.0;
+		return quadratic_roots<FP>((FP)1.0, (FP)0.0, p, xroots + 1) + 1;
+	}
+	return depressed_roots(p, (FP)0.5 * q, (FP)0.0, xroots);
+}
+template int depressed_cubic_roots(double p, double q, double* xroots);
+template int depressed_cubic_roots(float p, float q, float* xroots);
+template int depressed_cubic_roots(long double p, long double q, long double* xroots);
+#ifdef CUBIC_FLOAT128
+template int depressed_cubic_roots(__float128 p, __float128 q, __float128* xroots);
+#endif
+
+/**
+ * Same as 'depressed_cubic_roots()' for equations known to have three real roots (p <= 0), such as characteristic
+ * equations of symmetric matrices. Only the trigonometric method is evaluated.
+ */
+template<typename FP>
+int depressed_cubic_roots_trig(FP p, FP q, FP* xroots)
+{
+	depressed_roots_trig<FP, false>(p, (FP)0.5 * q, (FP)0.0, xroots);
+	return 3;
+}
+template int depressed_cubic_roots_trig(double p, double q, double* xroots);
+template int depressed_cubic_roots_trig(float p, float q, float* xroots);
+template int depressed_cubic_roots_trig(long double p, long double q, long double* xroots);
+#ifdef CUBIC_FLOAT128
+template int depressed_cubic_roots_trig(__float128 p, __float128 q, __float128* xroots);
+#endif
 
 
 /**
@@ -202,14 +263,15 @@ template int cubic_roots(float a, float b, float c, float d, float* xroots);
 * Note* implementation only return real roots and checks if the equation is linear.
 */
 template<typename FP>
-inline int qdrtc(FP A, FP B, FP C, FP* xroots)
+int qdrtc(FP A, FP B, FP C, FP* xroots)
 {
-	constexpr FP EPSILON = std::is_same<float, typename std::remove_cv<FP>::type>::value ? FLT_EPSILON : DBL_EPSILON;
+	using namespace std;
+	constexpr FP EPSILON = fp_traits<FP>::epsilon;
 
-	if (std::abs(A) < EPSILON)
+	if (abs(A) < EPSILON)
 	{
 		/* Linear equation */
-		if (std::abs(B) > EPSILON)
+		if (abs(B) > EPSILON)
 		{
 			*xroots = -C / B;
 			return 1;
@@ -230,7 +292,7 @@ inline int qdrtc(FP A, FP B, FP C, FP* xroots)
 		*/
 	}
 	else {
-		FP r = b + std::copysign(std::sqrt(q), b); /* sqrt(q) * sign(b) as q >= 0 */
+		FP r = b + copysign(sqrt(q), b); /* sqrt(q) * sign(b) as q >= 0 */
 		if (r == (FP)0.0) {
 
 			xroots[0] = C / A;
@@ -243,6 +305,12 @@ inline int qdrtc(FP A, FP B, FP C, FP* xroots)
 	}
 	return 2;
 }
+template int qdrtc(double A, double B, double C, double* xroots);
+template int qdrtc(float A, float B, float C, float* xroots);
+template int qdrtc(long double A, long double B, long double C, long double* xroots);
+#ifdef CUBIC_FLOAT128
+template int qdrtc(__float128 A, __float128 B, __float128 C, __float128* xroots);
+#endif
 
 
 template<typename FP>
@@ -264,11 +332,14 @@ inline void qbc_eval(FP X, FP A, FP B, FP C, FP D, FP& Q, FP& Q_p, FP& B1, FP& C
  * 'To Solve a Real Cubic Equation' authored by W. Kahan.
  * 
  * Note* implementation only return real roots and checks if the equation is linear.
+ *
+ * If BOUNDED the Newton iteration is stopped after max_iter steps, the roots are then computed by 'cubic_roots()'
+ * and converged is set to false.
  */
-template<typename FP>
-int cubic_roots_qbc(FP A, FP B, FP C, FP D, FP* xroots) {
+template<typename FP, bool BOUNDED>
+int cubic_roots_qbc_impl(FP A, FP B, FP C, FP D, FP* xroots, int max_iter, bool* converged) {
 	using namespace std;
-	constexpr FP EPSILON = is_same<float, typename remove_cv<FP>::type>::value ? FLT_EPSILON : DBL_EPSILON;
+	constexpr FP EPSILON = fp_traits<FP>::epsilon;
 
 	int N = 0;
 	FP b1, c2;
@@ -292,18 +363,27 @@ int cubic_roots_qbc(FP A, FP B, FP C, FP D, FP* xroots) {
 		qbc_eval(X, A, B, C, D, q, q_p, b1, c2);
 
 		t = q / A;
-		r = std::cbrt(std::abs(t));
-		s = std::copysign((FP)1.0, t);
+		r = cbrt(abs(t));
+		s = copysign((FP)1.0, t);
 
 		t = -q_p / A;
 		if (t > 0) {
-			r = (FP)1.324717957244746025960908854478097340734404056901733365 * std::fmax(r, std::sqrt(t));
+			r = (FP)1.324717957244746025960908854478097340734404056901733365 * fmax(r, sqrt(t));
 		}
 
 		FP x0 = X - r * s;
 		if (x0 != X) {
 			int i = 0;
 			do {
+				if constexpr (BOUNDED) {
+					if (i++ == max_iter) {
+						/* Iteration budget exceeded, fall back on the closed form solution. */
+						if (converged) {
+							*converged = false;
+						}
+						return cubic_roots<FP>(A, B, C, D, xroots);
+					}
+				}
 				X = x0;
 				qbc_eval(X, A, B, C, D, q, q_p, b1, c2);
 				if (q_p == 0) {
@@ -314,7 +394,7 @@ int cubic_roots_qbc(FP A, FP B, FP C, FP D, FP* xroots) {
 				}
 			} while (x0 * s > X * s);
 
-			if (std::abs(A) * X * X > std::abs(D / X)) {
+			if (abs(A) * X * X > abs(D / X)) {
 				c2 = -D / X;
 				b1 = (c2 - C) / X;
 			}
@@ -322,7 +402,32 @@ int cubic_roots_qbc(FP A, FP B, FP C, FP D, FP* xroots) {
 		N = 1;
 		*xroots++ = X;
 	}
+	if (BOUNDED && converged) {
+		*converged = true;
+	}
 	return N + qdrtc(A, b1, c2, xroots);
 }
+
+template<typename FP>
+int cubic_roots_qbc(FP A, FP B, FP C, FP D, FP* xroots)
+{
+	return cubic_roots_qbc_impl<FP, false>(A, B, C, D, xroots, 0, nullptr);
+}
 template int cubic_roots_qbc(double a, double b, double c, double d, double* xroots);
-template int cubic_roots_qbc(float a, float b, float c, float d, float* xroots);
\ No newline at end of file
+template int cubic_roots_qbc(float a, float b, float c, float d, float* xroots);
+template int cubic_roots_qbc(long double a, long double b, long double c, long double d, long double* xroots);
+#ifdef CUBIC_FLOAT128
+template int cubic_roots_qbc(__float128 a, __float128 b, __float128 c, __float128 d, __float128* xroots);
+#endif
+
+template<typename FP>
+int cubic_roots_qbc_bounded(FP A, FP B, FP C, FP D, FP* xroots, int max_iter, bool* converged)
+{
+	return cubic_roots_qbc_impl<FP, true>(A, B, C, D, xroots, max_iter, converged);
+}
+template int cubic_roots_qbc_bounded(double a, double b, double c, double d, double* xroots, int max_iter, bool* converged);
+template int cubic_roots_qbc_bounded(float a, float b, float c, float d, float* xroots, int max_iter, bool* converged);
+template int cubic_roots_qbc_bounded(long double a, long double b, long double c, long double d, long double* xroots, int max_iter, bool* converged);
+#ifdef CUBIC_FLOAT128
+template int cubic_roots_qbc_bounded(__float128 a, __float128 b, __float128 c, __float128 d, __float128* xroots, int max_iter, bool* converged);
+#endif
@@ -0,0 +1,309 @@
+/* Batch algorithms for computing real roots of many cubic equations (3rd order polynomials).
+*
+* Provided under the Unlicense License (public domain, see license terms at http://unlicense.org/).
+*/
+#include "cubic/cubic_batch.h"
+#include "cubic/eft.h"
+#include "cubic/ndgrid.h"
+#include "cubic_kernels.h"
+
+#include<algorithm>
+#ifdef _OPENMP
+#include<omp.h>
+#endif
+
+
+namespace {
+	/* Thread queries, serial fallback if compiled without OpenMP. */
+	inline int num_threads()
+	{
+#ifdef _OPENMP
+		return omp_get_num_threads();
+#else
+		return 1;
+#endif
+	}
+	inline int thread_num()
+	{
+#ifdef _OPENMP
+		return omp_get_thread_num();
+#else
+		return 0;
+#endif
+	}
+
+	/**
+	 * Concatenate the thread local buffers into out in thread order, must be called by every thread of the enclosing
+	 * parallel region. thread_offset is shared scratch (root counts shifted one step, prefix-summed into the output
+	 * offset of each thread). Returns the offset of the calling thread's buffer in out, out is complete on return.
+	 */
+	template<typename T>
+	std::int64_t compact_thread_buffers(const std::vector<T>& local, std::vector<T>& out, std::vector<std::int64_t>& thread_offset)
+	{
+		const int nthreads = num_threads();
+		const int tid = thread_num();
+#pragma omp single
+		thread_offset.assign(nthreads + 1, 0);
+		/* Implicit barrier */
+		thread_offset[tid + 1] = (std::int64_t)local.size();
+
+#pragma omp barrier
+#pragma omp single
+		{
+			for (int t = 0; t < nthreads; t++) {
+				thread_offset[t + 1] += thread_offset[t];
+			}
+			out.resize(thread_offset[nthreads]);
+		}
+		/* Implicit barrier */
+		const std::int64_t offset = thread_offset[tid];
+		std::copy(local.begin(), local.end(), out.begin() + offset);
+#pragma omp barrier
+		return offset;
+	}
+
+	/* Grid points generated per task in 'cubic_roots_grid()'. */
+	constexpr std::int64_t GRID_FILL_BLOCK_SIZE = 4096;
+
+	/* Equations processed per block in 'cubic_roots_classified()', sized for the block local buffers to stay in L1/L2. */
+	constexpr std::int64_t CLASSIFY_BLOCK_SIZE = 1024;
+
+	/* Verify the relative residual of each root is within tolerance. */
+	template<typename FP>
+	inline bool roots_within_tolerance(const FP* A, const FP* xroots, int n, FP tol)
+	{
+		using namespace std;
+		for (int k = 0; k < n; k++) {
+			FP x = abs(xroots[k]);
+			FP scale = ((abs(A[0]) * x + abs(A[1])) * x + abs(A[2])) * x + abs(A[3]);
+			if (!(abs(cubic_compensated(A[0], A[1], A[2], A[3], xroots[k])) <= tol * scale)) {
+				return false;
+			}
+		}
+		return true;
+	}
+}
+
+
+template<typename FP>
+void cubic_roots_batch(const FP* coeffs, std::int64_t N, FP* xroots, int* nroots, CBRT_SOLVER<FP> solver)
+{
+#pragma omp parallel for schedule(static)
+	for (std::int64_t i = 0; i < N; i++) {
+		const FP* A = coeffs + 4 * i;
+		nroots[i] = solver(A[0], A[1], A[2], A[3], xroots + 3 * i);
+	}
+}
+template void cubic_roots_batch(const double* coeffs, std::int64_t N, double* xroots, int* nroots, CBRT_SOLVER<double> solver);
+template void cubic_roots_batch(const float* coeffs, std::int64_t N, float* xroots, int* nroots, CBRT_SOLVER<float> solver);
+
+template<typename FP>
+void monic_cubic_roots_batch(const FP* coeffs, std::int64_t N, FP* xroots, int* nroots)
+{
+#pragma omp parallel for schedule(static)
+	for (std::int64_t i = 0; i < N; i++) {
+		const FP* A = coeffs + 3 * i;
+		nroots[i] = monic_cubic_roots<FP>(A[0], A[1], A[2], xroots + 3 * i);
+	}
+}
+template void monic_cubic_roots_batch(const double* coeffs, std::int64_t N, double* xroots, int* nroots);
+template void monic_cubic_roots_batch(const float* coeffs, std::int64_t N, float* xroots, int* nroots);
+
+template<typename FP>
+void depressed_cubic_roots_batch(const FP* coeffs, std::int64_t N, FP* xroots, int* nroots)
+{
+#pragma omp parallel for schedule(static)
+	for (std::int64_t i = 0; i < N; i++) {
+		const FP* A = coeffs + 2 * i;
+		nroots[i] = depressed_cubic_roots<FP>(A[0], A[1], xroots + 3 * i);
+	}
+}
+template void depressed_cubic_roots_batch(const double* coeffs, std::int64_t N, double* xroots, int* nroots);
+template void depressed_cubic_roots_batch(const float* coeffs, std::int64_t N, float* xroots, int* nroots);
+
+template<typename FP>
+void cubic_roots_classified(const FP* coeffs, std::int64_t N, FP* xroots, int* nroots)
+{
+	constexpr FP third = (FP)(1.0 / 3.0);
+	constexpr FP EPSILON = std::numeric_limits<FP>::epsilon();
+	const std::int64_t nblock = (N + CLASSIFY_BLOCK_SIZE - 1) / CLASSIFY_BLOCK_SIZE;
+
+#pragma omp parallel for schedule(static)
+	for (std::int64_t blk = 0; blk < nblock; blk++) {
+		const std::int64_t begin = blk * CLASSIFY_BLOCK_SIZE;
+		const std::int64_t n = std::min(CLASSIFY_BLOCK_SIZE, N - begin);
+		FP p[CLASSIFY_BLOCK_SIZE], halfq[CLASSIFY_BLOCK_SIZE], bover3[CLASSIFY_BLOCK_SIZE], yy[CLASSIFY_BLOCK_SIZE];
+		/* Branch of each lane: 0 degenerate, 1 trigonometric, 2 Cardano */
+		int branch[CLASSIFY_BLOCK_SIZE];
+
+		/* Reduce, depress and classify all lanes. */
+#pragma omp simd
+		for (std::int64_t l = 0; l < n; l++) {
+			const FP* A = coeffs + 4 * (begin + l);
+			FP b = A[1] / A[0], c = A[2] / A[0], d = A[3] / A[0];
+			FP b3 = b * third;
+			FP pl = c - b3 * b;
+			FP hq = b3 * b3 * b3 - (FP)0.5 * b3 * c + (FP)0.5 * d;
+			FP y = pl / (FP)27.0 * pl * pl + hq * hq;
+			p[l] = pl; halfq[l] = hq; bover3[l] = b3; yy[l] = y;
+			bool degenerate = std::abs(A[3]) < EPSILON || std::abs(A[0]) < EPSILON || (y < (FP)0.0 && std::abs(pl) < EPSILON);
+			branch[l] = degenerate ? 0 : (y < (FP)0.0 ? 1 : 2);
+		}
+
+		/* Partition lane indices into per-branch worklists. */
+		int work[3][CLASSIFY_BLOCK_SIZE];
+		int count[3] = { 0, 0, 0 };
+		for (int l = 0; l < (int)n; l++) {
+			const int k = branch[l];
+			work[k][count[k]++] = l;
+		}
+
+		/* Dense branch kernels, scattering roots to the output. */
+#pragma omp simd
+		for (int w = 0; w < count[1]; w++) {
+			const int l = work[1][w];
+			FP x[3];
+			depressed_roots_trig<FP>(p[l], halfq[l], bover3[l], x);
+			FP* out = xroots + 3 * (begin + l);
+			out[0] = x[0]; out[1] = x[1]; out[2] = x[2];
+			nroots[begin + l] = 3;
+		}
+#pragma omp simd
+		for (int w = 0; w < count[2]; w++) {
+			const int l = work[2][w];
+			xroots[3 * (begin + l)] = depressed_root_cardano<FP>(p[l], halfq[l], bover3[l], yy[l]);
+			nroots[begin + l] = 1;
+		}
+		for (int w = 0; w < count[0]; w++) {
+			const std::int64_t i = begin + work[0][w];
+			const FP* A = coeffs + 4 * i;
+			nroots[i] = cubic_roots<FP>(A[0], A[1], A[2], A[3], xroots + 3 * i);
+		}
+	}
+}
+template void cubic_roots_classified(const double* coeffs, std::int64_t N, double* xroots, int* nroots);
+template void cubic_roots_classified(const float* coeffs, std::int64_t N, float* xroots, int* nroots);
+
+template<typename FP>
+std::int64_t cubic_roots_hybrid(const FP* coeffs, std::int64_t N, FP* xroots, int* nroots, FP tol)
+{
+	/* Indices of equations failing the residual check. */
+	std::vector<std::int64_t> worklist;
+	std::vector<std::int64_t> thread_offset;
+
+#pragma omp parallel
+	{
+		const int nthreads = num_threads();
+		const int tid = thread_num();
+
+		/* Closed form solve and residual check, failing indices are collected locally. */
+		const std::int64_t begin = N * tid / nthreads;
+		const std::int64_t end = N * (tid + 1) / nthreads;
+		std::vector<std::int64_t> local;
+		for (std::int64_t i = begin; i < end; i++) {
+			const FP* A = coeffs + 4 * i;
+			FP* x = xroots + 3 * i;
+			nroots[i] = cubic_roots<FP>(A[0], A[1], A[2], A[3], x);
+			if (!roots_within_tolerance(A, x, nroots[i], tol)) {
+				local.push_back(i);
+			}
+		}
+		compact_thread_buffers(local, worklist, thread_offset);
+
+		/* Re-solve the compacted worklist, QBC iteration counts vary so work is scheduled dynamically. */
+		const std::int64_t nwork = (std::int64_t)worklist.size();
+#pragma omp for schedule(dynamic, 256)
+		for (std::int64_t w = 0; w < nwork; w++) {
+			const std::int64_t i = worklist[w];
+			const FP* A = coeffs + 4 * i;
+			nroots[i] = cubic_roots_qbc<FP>(A[0], A[1], A[2], A[3], xroots + 3 * i);
+		}
+	}
+	return (std::int64_t)worklist.size();
+}
+template std::int64_t cubic_roots_hybrid(const double* coeffs, std::int64_t N, double* xroots, int* nroots, double tol);
+template std::int64_t cubic_roots_hybrid(const float* coeffs, std::int64_t N, float* xroots, int* nroots, float tol);
+
+
+template<typename FP>
+std::int64_t cubic_roots_refined(const FP* coeffs, std::int64_t N, FP* xroots, int* nroots, FP cond_threshold, CBRT_SOLVER<FP> solver)
+{
+	std::int64_t nrefined = 0;
+#pragma omp parallel for schedule(dynamic, 1024) reduction(+:nrefined)
+	for (std::int64_t i = 0; i < N; i++) {
+		const FP* A = coeffs + 4 * i;
+		FP* x = xroots + 3 * i;
+		nroots[i] = solver(A[0], A[1], A[2], A[3], x);
+		bool refined = false;
+		for (int k = 0; k < nroots[i]; k++) {
+			/* Negated comparison also refines roots with NaN (0 / 0) condition */
+			if (!(cubic_root_condition(A[0], A[1], A[2], A[3], x[k]) <= cond_threshold)) {
+				x[k] = refine_root_compensated(A[0], A[1], A[2], A[3], x[k]);
+				refined = true;
+			}
+		}
+		nrefined += refined;
+	}
+	return nrefined;
+}
+template std::int64_t cubic_roots_refined(const double* coeffs, std::int64_t N, double* xroots, int* nroots, double cond_threshold, CBRT_SOLVER<double> solver);
+template std::int64_t cubic_roots_refined(const float* coeffs, std::int64_t N, float* xroots, int* nroots, float cond_threshold, CBRT_SOLVER<float> solver);
+
+template<typename FP>
+std::int64_t cubic_roots_csr(const FP* coeffs, std::int64_t N, std::vector<FP>& xroots, std::int64_t* offsets, CBRT_SOLVER<FP> solver)
+{
+	std::vector<std::int64_t> thread_offset;
+	offsets[0] = 0;
+
+#pragma omp parallel
+	{
+		const int nthreads = num_threads();
+		const int tid = thread_num();
+
+		/* Solve contiguous chunk into a local buffer, store root count per equation. */
+		const std::int64_t begin = N * tid / nthreads;
+		const std::int64_t end = N * (tid + 1) / nthreads;
+		std::vector<FP> local;
+		local.reserve(end - begin);
+		FP res[3];
+		for (std::int64_t i = begin; i < end; i++) {
+			const FP* A = coeffs + 4 * i;
+			int n = solver(A[0], A[1], A[2], A[3], res);
+			local.insert(local.end(), res, res + n);
+			offsets[i + 1] = n;
+		}
+		/* Scatter the compacted roots, local prefix-sum of the counts. */
+		std::int64_t offset = compact_thread_buffers(local, xroots, thread_offset);
+		for (std::int64_t i = begin; i < end; i++) {
+			offset += offsets[i + 1];
+			offsets[i + 1] = offset;
+		}
+	}
+	return offsets[N];
+}
+template std::int64_t cubic_roots_csr(const double* coeffs, std::int64_t N, std::vector<double>& xroots, std::int64_t* offsets, CBRT_SOLVER<double> solver);
+template std::int64_t cubic_roots_csr(const float* coeffs, std::int64_t N, std::vector<float>& xroots, std::int64_t* offsets, CBRT_SOLVER<float> solver);
+
+template<typename FP>
+void cubic_roots_grid(const NdgridView<FP, 4>& grid, std::int64_t chunk_size, const GRID_ROOTS_CALLBACK<FP>& f, CBRT_SOLVER<FP> solver)
+{
+	chunk_size = std::max<std::int64_t>(1, std::min(chunk_size, grid.size()));
+	/* Buffers are first touched with the schedule of 'cubic_roots_batch()'. */
+	AllocConfig alloc;
+	alloc.first_touch_items = chunk_size;
+	AlignedBuffer<FP> coeffs(4 * chunk_size, alloc), xroots(3 * chunk_size, alloc);
+	AlignedBuffer<int> nroots(chunk_size, alloc);
+	for (std::int64_t k = 0; k < grid.num_chunks(chunk_size); k++) {
+		const IndexRange points = grid.chunk(k, chunk_size);
+		const std::int64_t nblocks = (points.size() + GRID_FILL_BLOCK_SIZE - 1) / GRID_FILL_BLOCK_SIZE;
+#pragma omp parallel for schedule(static)
+		for (std::int64_t b = 0; b < nblocks; b++) {
+			const std::int64_t start = b * GRID_FILL_BLOCK_SIZE;
+			grid.fill(points.slice(start, std::min(GRID_FILL_BLOCK_SIZE, points.size() - start)), coeffs.data() + 4 * start);
+		}
+		cubic_roots_batch<FP>(coeffs.data(), points.size(), xroots.data(), nroots.data(), solver);
+		f(points, coeffs.data(), xroots.data(), nroots.data());
+	}
+}
+template void cubic_roots_grid(const NdgridView<double, 4>& grid, std::int64_t chunk_size, const GRID_ROOTS_CALLBACK<double>& f, CBRT_SOLVER<double> solver);
+template void cubic_roots_grid(const NdgridView<float, 4>& grid, std::int64_t chunk_size, const GRID_ROOTS_CALLBACK<float>& f, CBRT_SOLVER<float> solver);
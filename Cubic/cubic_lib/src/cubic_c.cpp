@@ -0,0 +1,103 @@
+/* C entry points of the root solvers.
+*
+* Provided under the Unlicense License (public domain, see license terms at http://unlicense.org/).
+*/
+#include "cubic/cubic_c.h"
+#include "cubic/cubic.h"
+#include "cubic/cubic_batch.h"
+
+#ifdef _OPENMP
+#include<omp.h>
+#endif
+
+int cubic_abi_version(void) { return CUBIC_ABI_VERSION; }
+
+
+int cubic_roots_d(double a, double b, double c, double d, double* xroots) { return cubic_roots<double>(a, b, c, d, xroots); }
+int cubic_roots_f(float a, float b, float c, float d, float* xroots) { return cubic_roots<float>(a, b, c, d, xroots); }
+int cubic_roots_fast_d(double a, double b, double c, double d, double* xroots) { return cubic_roots_fast<double>(a, b, c, d, xroots); }
+int cubic_roots_fast_f(float a, float b, float c, float d, float* xroots) { return cubic_roots_fast<float>(a, b, c, d, xroots); }
+int cubic_roots_qbc_d(double a, double b, double c, double d, double* xroots) { return cubic_roots_qbc<double>(a, b, c, d, xroots); }
+int cubic_roots_qbc_f(float a, float b, float c, float d, float* xroots) { return cubic_roots_qbc<float>(a, b, c, d, xroots); }
+int quadratic_roots_d(double a, double b, double c, double* xroots) { return quadratic_roots<double>(a, b, c, xroots); }
+int quadratic_roots_f(float a, float b, float c, float* xroots) { return quadratic_roots<float>(a, b, c, xroots); }
+int qdrtc_d(double a, double b, double c, double* xroots) { return qdrtc<double>(a, b, c, xroots); }
+int qdrtc_f(float a, float b, float c, float* xroots) { return qdrtc<float>(a, b, c, xroots); }
+
+int cubic_roots_qbc_bounded_d(double a, double b, double c, double d, double* xroots, int max_iter, int* converged)
+{
+	bool conv;
+	const int n = cubic_roots_qbc_bounded<double>(a, b, c, d, xroots, max_iter, &conv);
+	if (converged) {
+		*converged = conv;
+	}
+	return n;
+}
+int cubic_roots_qbc_bounded_f(float a, float b, float c, float d, float* xroots, int max_iter, int* converged)
+{
+	bool conv;
+	const int n = cubic_roots_qbc_bounded<float>(a, b, c, d, xroots, max_iter, &conv);
+	if (converged) {
+		*converged = conv;
+	}
+	return n;
+}
+
+void cubic_roots_batch_d(const double* coeffs, int64_t N, double* xroots, int* nroots)
+{
+	cubic_roots_batch<double>(coeffs, N, xroots, nroots, &cubic_roots<double>);
+}
+void cubic_roots_batch_f(const float* coeffs, int64_t N, float* xroots, int* nroots)
+{
+	cubic_roots_batch<float>(coeffs, N, xroots, nroots, &cubic_roots<float>);
+}
+void cubic_roots_qbc_batch_d(const double* coeffs, int64_t N, double* xroots, int* nroots)
+{
+	cubic_roots_batch<double>(coeffs, N, xroots, nroots, &cubic_roots_qbc<double>);
+}
+void cubic_roots_qbc_batch_f(const float* coeffs, int64_t N, float* xroots, int* nroots)
+{
+	cubic_roots_batch<float>(coeffs, N, xroots, nroots, &cubic_roots_qbc<float>);
+}
+void cubic_roots_classified_d(const double* coeffs, int64_t N, double* xroots, int* nroots)
+{
+	cubic_roots_classified<double>(coeffs, N, xroots, nroots);
+}
+void cubic_roots_classified_f(const float* coeffs, int64_t N, float* xroots, int* nroots)
+{
+	cubic_roots_classified<float>(coeffs, N, xroots, nroots);
+}
+
+void cubic_set_num_threads(int n)
+{
+#ifdef _OPENMP
+	omp_set_num_threads(n > 0 ? n : omp_get_num_procs());
+#else
+	(void)n;
+#endif
+}
+int cubic_get_max_threads(void)
+{
+#ifdef _OPENMP
+	return omp_get_max_threads();
+#else
+	return 1;
+#endif
+}
+
+int64_t cubic_roots_hybrid_d(const double* coeffs, int64_t N, double* xroots, int* nroots, double tol)
+{
+	return cubic_roots_hybrid<double>(coeffs, N, xroots, nroots, tol);
+}
+int64_t cubic_roots_hybrid_f(const float* coeffs, int64_t N, float* xroots, int* nroots, float tol)
+{
+	return cubic_roots_hybrid<float>(coeffs, N, xroots, nroots, tol);
+}
+int64_t cubic_roots_refined_d(const double* coeffs, int64_t N, double* xroots, int* nroots, double cond_threshold)
+{
+	return cubic_roots_refined<double>(coeffs, N, xroots, nroots, cond_threshold);
+}
+int64_t cubic_roots_refined_f(const float* coeffs, int64_t N, float* xroots, int* nroots, float cond_threshold)
+{
+	return cubic_roots_refined<float>(coeffs, N, xroots, nroots, cond_threshold);
+}
@@ -0,0 +1,189 @@
+#pragma once
+/* Inline kernels shared by the closed form solvers, not part of the public interface.
+*
+* Provided under the Unlicense License (public domain, see license terms at http://unlicense.org/).
+*/
+#include "cubic/fast_math.h"
+#include "cubic/fp_traits.h"
+#include <cmath>
+#include <type_traits>
+
+
+/**
+ * Real root of the depressed cubic equation
+ *
+ *		t^3 + pt + q = 0,	x = t - bover3
+ *
+ * by Cardano's method, given halfq = q / 2 and the non-negative discriminant yy = (p / 3)^3 + (q / 2)^2.
+ */
+template<typename FP, bool FAST = false>
+inline FP depressed_root_cardano(FP p, FP halfq, FP bover3, FP yy)
+{
+	using namespace std;
+	FP y = sqrt(yy);
+	FP uuu = y - halfq;
+	FP vvv = -y - halfq;
+	FP www = abs(uuu) > abs(vvv) ? uuu : vvv;
+	FP w;
+	if constexpr (FAST) {
+		w = fast::cbrt(www);
+	}
+	else {
+		w = copysign(cbrt(abs(www)), www);
+	}
+	return w - p / ((FP)3.0 * w) - bover3;
+}
+
+/**
+ * Solve the depressed cubic equation
+ *
+ *		t^3 + pt + q = 0,	x = t - bover3
+ *
+ * given p, halfq = q / 2 and the shift bover3 applied to the roots.
+ *
+ * FAST substitutes the libm calls with the approximations in 'fast_math.h', evaluating a single sincos() in place
+ * of three cos() calls using cos(theta -+ 2pi/3) = -cos(theta) / 2 +- sin(theta) sqrt(3) / 2.
+ */
+template<typename FP, bool FAST = false>
+inline int depressed_roots(FP p, FP halfq, FP bover3, FP* xroots)
+{
+	using namespace std;
+	constexpr FP PI = fp_traits<FP>::pi;
+	constexpr FP PI2over3 = (FP)(PI * 2.0 / 3.0);
+	constexpr FP third = (FP)1.0 / (FP)3.0;
+	constexpr FP EPSILON = fp_traits<FP>::epsilon;
+
+	FP yy = p / (FP)27.0 * p * p + halfq * halfq;
+
+	if (yy < (FP)0.0) /* Sqrt is negative: three real solutions */
+	{
+		if (fabs(p) < EPSILON)
+		{
+			xroots[0] = -bover3;
+			xroots[1] = xroots[0];
+			xroots[2] = xroots[0];
+		}
+		else
+		{
+			FP uu = (FP)-4.0 / (FP)3.0 * p;
+			FP u = sqrt(uu);
+			if constexpr (FAST) {
+				constexpr FP sqrt3over2 = (FP)0.866025403784438646763723170752936183471402626905190314027903489;
+				FP theta = fast::acos((FP)-8.0 * halfq / (u * uu)) * third;
+				FP s, c;
+				fast::sincos(theta, s, c);
+				FP uc = (FP)-0.5 * u * c;
+				FP us = sqrt3over2 * u * s;
+				xroots[0] = u * c - bover3;
+				xroots[1] = uc + us - bover3;
+				xroots[2] = uc - us - bover3;
+			}
+			else {
+				FP theta = acos((FP)-8.0 * halfq / (u * uu)) * third;
+				xroots[0] = u * cos(theta) - bover3;
+				xroots[1] = u * cos(theta - PI2over3) - bover3;
+				xroots[2] = u * cos(theta + PI2over3) - bover3;
+			}
+		}
+		return 3;
+	}
+	else
+	{
+		/*  Sqrt is positive: one real solution */
+		*xroots = depressed_root_cardano<FP, FAST>(p, halfq, bover3, yy);
+		return 1;
+	}
+}
+
+/**
+ * Solve the depressed cubic equation
+ *
+ *		t^3 + pt + q = 0,	x = t - bover3
+ *
+ * assuming three real roots (p <= 0, discriminant <= 0), using only the trigonometric method. The acos() argument
+ * is clamped to [-1, 1] absorbing rounding errors, p = 0 yields a triple root without branching. Roots are
+ * ordered xroots[0] >= xroots[1] >= xroots[2].
+ */
+template<typename FP, bool FAST = false>
+inline void depressed_roots_trig(FP p, FP halfq, FP bover3, FP* xroots)
+{
+	using namespace std;
+	constexpr FP PI = fp_traits<FP>::pi;
+	constexpr FP PI2over3 = (FP)(PI * 2.0 / 3.0);
+	constexpr FP third = (FP)1.0 / (FP)3.0;
+
+	FP uu = (FP)-4.0 / (FP)3.0 * p;
+	uu = uu > (FP)0.0 ? uu : (FP)0.0;
+	FP u = sqrt(uu);
+	/* Comparisons are false for the NaN from 0 / 0, mapping it to -1 */
+	FP r = (FP)-8.0 * halfq / (u * uu);
+	r = r > (FP)-1.0 ? r : (FP)-1.0;
+	r = r < (FP)1.0 ? r : (FP)1.0;
+	if constexpr (FAST) {
+		constexpr FP sqrt3over2 = (FP)0.866025403784438646763723170752936183471402626905190314027903489;
+		FP theta = fast::acos(r) * third;
+		FP s, c;
+		fast::sincos(theta, s, c);
+		FP uc = (FP)-0.5 * u * c;
+		FP us = sqrt3over2 * u * s;
+		xroots[0] = u * c - bover3;
+		xroots[1] = uc + us - bover3;
+		xroots[2] = uc - us - bover3;
+	}
+	else {
+		FP theta = acos(r) * third;
+		xroots[0] = u * cos(theta) - bover3;
+		xroots[1] = u * cos(theta - PI2over3) - bover3;
+		xroots[2] = u * cos(theta + PI2over3) - bover3;
+	}
+}
+
+/**
+ * Solve the depressed cubic equation
+ *
+ *		t^3 + pt + q = 0,	x = t - bover3
+ *
+ * for all three (possibly complex) roots, written as xre[k] + i xim[k]. Three real roots are computed as in
+ * 'depressed_roots()' and ordered descending. Otherwise xre[0] is the real root and the complex conjugate pair is
+ * obtained from the Cardano terms u = cbrt(-q/2 + sqrt(yy)), v = -p / 3u as t = -(u + v) / 2 +- i sqrt(3) / 2 (u - v),
+ * with xim[1] >= 0 and xim[2] = -xim[1]. Returns the number of real roots (1 or 3).
+ */
+template<typename FP, bool FAST = false>
+inline int depressed_roots_complex(FP p, FP halfq, FP bover3, FP* xre, FP* xim)
+{
+	using namespace std;
+	constexpr FP sqrt3over2 = (FP)0.866025403784438646763723170752936183471402626905190314027903489;
+
+	FP yy = p / (FP)27.0 * p * p + halfq * halfq;
+	if (yy < (FP)0.0)
+	{
+		depressed_roots<FP, FAST>(p, halfq, bover3, xre);
+		xim[0] = (FP)0.0;
+		xim[1] = (FP)0.0;
+		xim[2] = (FP)0.0;
+		return 3;
+	}
+	FP y = sqrt(yy);
+	FP uuu = y - halfq;
+	FP vvv = -y - halfq;
+	FP www = abs(uuu) > abs(vvv) ? uuu : vvv;
+	FP u = FAST ? fast::cbrt(www) : copysign(cbrt(abs(www)), www);
+	/* u = 0 only if p = q = 0 (triple root) */
+	FP v = u != (FP)0.0 ? -p / ((FP)3.0 * u) : (FP)0.0;
+	FP im = sqrt3over2 * abs(u - v);
+	xre[0] = u + v - bover3;
+	xre[1] = (FP)-0.5 * (u + v) - bover3;
+	xre[2] = xre[1];
+	xim[0] = (FP)0.0;
+	xim[1] = im;
+	xim[2] = -im;
+	if (im > (FP)0.0) {
+		return 1;
+	}
+	/* yy = 0: double (or triple) real root, ordered descending as for three distinct roots. */
+	if (xre[1] > xre[0]) {
+		xre[2] = xre[0];
+		xre[0] = xre[1];
+	}
+	return 3;
+}
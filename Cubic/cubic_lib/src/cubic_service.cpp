@@ -0,0 +1,167 @@
+/* Micro-batching service solving cubic equations submitted one at a time from many threads.
+*
+* Provided under the Unlicense License (public domain, see license terms at http://unlicense.org/).
+*/
+#include "cubic/cubic_service.h"
+#include "cubic/cubic_batch.h"
+#include "mpmc_queue.h"
+
+#include<algorithm>
+#include<atomic>
+#include<condition_variable>
+#include<mutex>
+#include<optional>
+#include<thread>
+#include<vector>
+#ifdef _OPENMP
+#include<omp.h>
+#endif
+
+
+template<typename FP>
+struct CubicService<FP>::Impl {
+	/* Either the promise (future returning 'submit()') or the callback is set. The promise is only constructed
+	 * when needed as it allocates its shared state, queue cells and batch slots hold empty requests. */
+	struct Request {
+		FP coeffs[4];
+		std::optional<std::promise<Result>> promise;
+		Callback callback;
+	};
+
+	Config config;
+	MPMCQueue<Request> queue;
+	std::vector<std::thread> workers;
+	std::atomic<bool> stop{ false };
+	std::atomic<std::uint64_t> batches{ 0 };
+
+	/* Idle workers sleep on the condition variable, producers only lock if a worker is sleeping. */
+	std::mutex mutex;
+	std::condition_variable wakeup;
+	std::atomic<int> sleeping{ 0 };
+
+	explicit Impl(const Config& config)
+		: config(config), queue(config.queue_capacity)
+	{
+	}
+
+	void push(Request& request)
+	{
+		while (!queue.try_push(request)) {
+			std::this_thread::yield();
+		}
+		/* Pairs with the fence in run(): either the worker sees the request or the producer sees the sleeper. */
+		std::atomic_thread_fence(std::memory_order_seq_cst);
+		if (sleeping.load() > 0) {
+			/* Lock ensures the worker is either before its emptiness check or waiting. */
+			{ std::lock_guard<std::mutex> lock(mutex); }
+			wakeup.notify_one();
+		}
+	}
+
+	void run()
+	{
+#ifdef _OPENMP
+		/* Batches are solved serially on each worker, the pool provides the parallelism. */
+		omp_set_num_threads(1);
+#endif
+		const int max_batch = config.max_batch > 0 ? config.max_batch : 1;
+		std::vector<Request> batch(max_batch);
+		std::vector<FP> coeffs(4 * max_batch), xroots(3 * max_batch);
+		std::vector<int> nroots(max_batch);
+
+		for (;;) {
+			if (!queue.try_pop(batch[0])) {
+				if (stop.load()) {
+					return;
+				}
+				std::unique_lock<std::mutex> lock(mutex);
+				sleeping++;
+				std::atomic_thread_fence(std::memory_order_seq_cst);
+				wakeup.wait(lock, [this] { return stop.load() || !queue.empty(); });
+				sleeping--;
+				continue;
+			}
+
+			/* Gather until the batch is full or the first request has waited max_wait. */
+			int n = 1;
+			const auto deadline = std::chrono::steady_clock::now() + config.max_wait;
+			while (n < max_batch) {
+				if (queue.try_pop(batch[n])) {
+					n++;
+				}
+				else if (stop.load() || std::chrono::steady_clock::now() >= deadline) {
+					break;
+				}
+				else {
+					std::this_thread::yield();
+				}
+			}
+
+			for (int i = 0; i < n; i++) {
+				std::copy(batch[i].coeffs, batch[i].coeffs + 4, coeffs.data() + 4 * i);
+			}
+			cubic_roots_classified<FP>(coeffs.data(), n, xroots.data(), nroots.data());
+			batches++;
+
+			for (int i = 0; i < n; i++) {
+				Result r = { nroots[i], { xroots[3 * i], xroots[3 * i + 1], xroots[3 * i + 2] } };
+				if (batch[i].callback) {
+					batch[i].callback(r);
+					batch[i].callback = nullptr;
+				}
+				else {
+					batch[i].promise->set_value(r);
+				}
+			}
+		}
+	}
+};
+
+
+template<typename FP>
+CubicService<FP>::CubicService(const Config& config)
+	: m_impl(new Impl(config))
+{
+	const int nworkers = config.num_workers > 0 ? config.num_workers : 1;
+	for (int i = 0; i < nworkers; i++) {
+		m_impl->workers.emplace_back(&Impl::run, m_impl.get());
+	}
+}
+
+template<typename FP>
+CubicService<FP>::~CubicService()
+{
+	{
+		std::lock_guard<std::mutex> lock(m_impl->mutex);
+		m_impl->stop.store(true);
+	}
+	m_impl->wakeup.notify_all();
+	for (std::thread& worker : m_impl->workers) {
+		worker.join();
+	}
+}
+
+template<typename FP>
+std::future<typename CubicService<FP>::Result> CubicService<FP>::submit(FP a, FP b, FP c, FP d)
+{
+	typename Impl::Request request = { { a, b, c, d }, std::promise<Result>(), nullptr };
+	std::future<Result> result = request.promise->get_future();
+	m_impl->push(request);
+	return result;
+}
+
+template<typename FP>
+void CubicService<FP>::submit(FP a, FP b, FP c, FP d, Callback callback)
+{
+	typename Impl::Request request = { { a, b, c, d }, std::nullopt, std::move(callback) };
+	m_impl->push(request);
+}
+
+template<typename FP>
+std::uint64_t CubicService<FP>::num_batches() const
+{
+	return m_impl->batches.load();
+}
+
+template class CubicService<double>;
+template class CubicService<float>;
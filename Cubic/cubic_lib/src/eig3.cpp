@@ -0,0 +1,305 @@
+/* Eigenvalues of 3x3 matrices computed from the characteristic cubic equation.
+*
+* Provided under the Unlicense License (public domain, see license terms at http://unlicense.org/).
+*/
+#include "cubic/eig3.h"
+#include "cubic_kernels.h"
+
+#include<algorithm>
+#include<cmath>
+#include<limits>
+
+
+namespace {
+
+	/* Elements processed per block in batch loops. */
+	constexpr std::int64_t BLOCK_SIZE = 256;
+
+	/**
+	* Scale and shift the symmetric matrix A into B = A / scale - shift * I (B stored in the same order as A)
+	* and build the depressed characteristic cubic t^3 + pt + q = 0 of B, returning p and halfq = q / 2.
+	*/
+	template<typename FP>
+	inline void eig3_sym_cubic(FP a00, FP a01, FP a02, FP a11, FP a12, FP a22, FP* B, FP& scale, FP& shift, FP& p, FP& halfq)
+	{
+		using namespace std;
+		FP m0 = abs(a00) > abs(a01) ? abs(a00) : abs(a01);
+		FP m1 = abs(a02) > abs(a11) ? abs(a02) : abs(a11);
+		FP m2 = abs(a12) > abs(a22) ? abs(a12) : abs(a22);
+		scale = m0 > m1 ? m0 : m1;
+		scale = scale > m2 ? scale : m2;
+		/* 1 / scale overflows for subnormal scales, clamped (a zero matrix yields the triple root zero for any scale). */
+		scale = scale > numeric_limits<FP>::min() ? scale : numeric_limits<FP>::min();
+		FP inv = (FP)1.0 / scale;
+		a00 *= inv; a01 *= inv; a02 *= inv;
+		a11 *= inv; a12 *= inv; a22 *= inv;
+
+		shift = (a00 + a11 + a22) * (FP)(1.0 / 3.0);
+		FP b00 = a00 - shift, b11 = a11 - shift, b22 = a22 - shift;
+		B[0] = b00; B[1] = a01; B[2] = a02;
+		B[3] = b11; B[4] = a12; B[5] = b22;
+
+		/* Characteristic equation of a trace free matrix: t^3 - (tr(B^2) / 2) t - det(B) = 0 */
+		p = -((FP)0.5 * (b00 * b00 + b11 * b11 + b22 * b22) + a01 * a01 + a02 * a02 + a12 * a12);
+		FP det = b00 * (b11 * b22 - a12 * a12) - a01 * (a01 * b22 - a12 * a02) + a02 * (a01 * a12 - b11 * a02);
+		halfq = (FP)-0.5 * det;
+	}
+
+	template<typename FP>
+	inline void cross(const FP* a, const FP* b, FP* c)
+	{
+		c[0] = a[1] * b[2] - a[2] * b[1];
+		c[1] = a[2] * b[0] - a[0] * b[2];
+		c[2] = a[0] * b[1] - a[1] * b[0];
+	}
+
+	template<typename FP>
+	inline FP dot(const FP* a, const FP* b)
+	{
+		return a[0] * b[0] + a[1] * b[1] + a[2] * b[2];
+	}
+
+	template<typename FP>
+	inline void normalize(FP* v)
+	{
+		FP inv = (FP)1.0 / std::sqrt(dot(v, v));
+		v[0] *= inv; v[1] *= inv; v[2] *= inv;
+	}
+
+	/**
+	* Eigenvector of the symmetric matrix B for the eigenvalue t, chosen as the cross product of two rows of B - tI
+	* with the largest magnitude. Valid for eigenvalues of multiplicity one.
+	*/
+	template<typename FP>
+	inline void eigenvector0(const FP* B, FP t, FP* v)
+	{
+		FP r0[3] = { B[0] - t, B[1], B[2] };
+		FP r1[3] = { B[1], B[3] - t, B[4] };
+		FP r2[3] = { B[2], B[4], B[5] - t };
+		FP c[3][3];
+		cross(r0, r1, c[0]);
+		cross(r0, r2, c[1]);
+		cross(r1, r2, c[2]);
+		FP d[3] = { dot(c[0], c[0]), dot(c[1], c[1]), dot(c[2], c[2]) };
+		int imax = d[0] >= d[1] ? (d[0] >= d[2] ? 0 : 2) : (d[1] >= d[2] ? 1 : 2);
+		if (d[imax] > (FP)0.0) {
+			FP inv = (FP)1.0 / std::sqrt(d[imax]);
+			v[0] = c[imax][0] * inv; v[1] = c[imax][1] * inv; v[2] = c[imax][2] * inv;
+		}
+		else {
+			/* B = tI, any vector is an eigenvector. */
+			v[0] = (FP)1.0; v[1] = (FP)0.0; v[2] = (FP)0.0;
+		}
+	}
+
+	/**
+	* Eigenvector of B for the eigenvalue t orthogonal to the (unit) eigenvector v0. The problem is reduced to the
+	* 2x2 matrix M = [u w]^T (B - tI) [u w] where u, w span the orthogonal complement of v0.
+	*/
+	template<typename FP>
+	inline void eigenvector1(const FP* B, const FP* v0, FP t, FP* v)
+	{
+		using namespace std;
+		/* Orthonormal basis u, w of the complement of v0. */
+		FP u[3], w[3];
+		if (abs(v0[0]) > abs(v0[1])) {
+			FP inv = (FP)1.0 / sqrt(v0[0] * v0[0] + v0[2] * v0[2]);
+			u[0] = -v0[2] * inv; u[1] = (FP)0.0; u[2] = v0[0] * inv;
+		}
+		else {
+			FP inv = (FP)1.0 / sqrt(v0[1] * v0[1] + v0[2] * v0[2]);
+			u[0] = (FP)0.0; u[1] = v0[2] * inv; u[2] = -v0[1] * inv;
+		}
+		cross(v0, u, w);
+
+		/* (B - tI) u and (B - tI) w */
+		FP Bu[3] = {
+			(B[0] - t) * u[0] + B[1] * u[1] + B[2] * u[2],
+			B[1] * u[0] + (B[3] - t) * u[1] + B[4] * u[2],
+			B[2] * u[0] + B[4] * u[1] + (B[5] - t) * u[2] };
+		FP Bw[3] = {
+			(B[0] - t) * w[0] + B[1] * w[1] + B[2] * w[2],
+			B[1] * w[0] + (B[3] - t) * w[1] + B[4] * w[2],
+			B[2] * w[0] + B[4] * w[1] + (B[5] - t) * w[2] };
+		FP m00 = dot(u, Bu), m01 = dot(u, Bw), m11 = dot(w, Bw);
+
+		/* Null vector (x, y) of M from its row with the largest entry. */
+		FP x, y;
+		if (abs(m00) >= abs(m11)) {
+			if (fmax(abs(m00), abs(m01)) > (FP)0.0) {
+				x = -m01; y = m00;
+			}
+			else {
+				x = (FP)1.0; y = (FP)0.0;
+			}
+		}
+		else {
+			x = m11; y = -m01;
+		}
+		for (int j = 0; j < 3; j++) {
+			v[j] = x * u[j] + y * w[j];
+		}
+		normalize(v);
+	}
+
+	/**
+	* Eigenvectors of B for the eigenvalues t[0] >= t[1] >= t[2]. The eigenvector of the most isolated extreme
+	* eigenvalue is computed first, remaining vectors are constrained to its orthogonal complement.
+	*/
+	template<typename FP>
+	inline void eigenvectors(const FP* B, const FP* t, FP v[3][3])
+	{
+		if (t[0] - t[1] >= t[1] - t[2]) {
+			eigenvector0(B, t[0], v[0]);
+			eigenvector1(B, v[0], t[1], v[1]);
+			cross(v[0], v[1], v[2]);
+		}
+		else {
+			eigenvector0(B, t[2], v[2]);
+			eigenvector1(B, v[2], t[1], v[1]);
+			cross(v[1], v[2], v[0]);
+		}
+	}
+}
+
+
+template<typename FP, bool FAST>
+void eig3_sym(const FP* A, FP* eval, FP* evec)
+{
+	FP B[6], scale, shift, p, halfq, t[3];
+	eig3_sym_cubic(A[0], A[1], A[2], A[3], A[4], A[5], B, scale, shift, p, halfq);
+	depressed_roots_trig<FP, FAST>(p, halfq, (FP)0.0, t);
+	/* Ascending order */
+	for (int k = 0; k < 3; k++) {
+		eval[k] = (t[2 - k] + shift) * scale;
+	}
+	if (evec) {
+		FP v[3][3];
+		eigenvectors(B, t, v);
+		for (int k = 0; k < 3; k++) {
+			for (int j = 0; j < 3; j++) {
+				evec[3 * k + j] = v[2 - k][j];
+			}
+		}
+	}
+}
+template void eig3_sym<double, false>(const double* A, double* eval, double* evec);
+template void eig3_sym<float, false>(const float* A, float* eval, float* evec);
+template void eig3_sym<double, true>(const double* A, double* eval, double* evec);
+template void eig3_sym<float, true>(const float* A, float* eval, float* evec);
+
+
+template<typename FP, bool FAST>
+void eig3_sym_batch(const FP* A, std::int64_t N, FP* eval, FP* evec)
+{
+	const std::int64_t nblock = (N + BLOCK_SIZE - 1) / BLOCK_SIZE;
+#pragma omp parallel for schedule(static)
+	for (std::int64_t b = 0; b < nblock; b++) {
+		const std::int64_t begin = b * BLOCK_SIZE;
+		const std::int64_t n = std::min(BLOCK_SIZE, N - begin);
+		/* Block local shifted matrices, cubic coefficients and roots, kept for the eigenvector pass. */
+		FP B[6][BLOCK_SIZE], scale[BLOCK_SIZE], shift[BLOCK_SIZE], p[BLOCK_SIZE], halfq[BLOCK_SIZE], t[3][BLOCK_SIZE];
+
+#pragma omp simd
+		for (std::int64_t l = 0; l < n; l++) {
+			const std::int64_t i = begin + l;
+			FP Bl[6];
+			eig3_sym_cubic(A[i], A[N + i], A[2 * N + i], A[3 * N + i], A[4 * N + i], A[5 * N + i], Bl, scale[l], shift[l], p[l], halfq[l]);
+			B[0][l] = Bl[0]; B[1][l] = Bl[1]; B[2][l] = Bl[2];
+			B[3][l] = Bl[3]; B[4][l] = Bl[4]; B[5][l] = Bl[5];
+		}
+#pragma omp simd
+		for (std::int64_t l = 0; l < n; l++) {
+			const std::int64_t i = begin + l;
+			FP tl[3];
+			depressed_roots_trig<FP, FAST>(p[l], halfq[l], (FP)0.0, tl);
+			t[0][l] = tl[0]; t[1][l] = tl[1]; t[2][l] = tl[2];
+			/* Ascending order */
+			eval[i] = (tl[2] + shift[l]) * scale[l];
+			eval[N + i] = (tl[1] + shift[l]) * scale[l];
+			eval[2 * N + i] = (tl[0] + shift[l]) * scale[l];
+		}
+
+		if (evec) {
+			for (std::int64_t l = 0; l < n; l++) {
+				const std::int64_t i = begin + l;
+				FP Bl[6] = { B[0][l], B[1][l], B[2][l], B[3][l], B[4][l], B[5][l] };
+				FP tl[3] = { t[0][l], t[1][l], t[2][l] };
+				FP v[3][3];
+				eigenvectors(Bl, tl, v);
+				for (int k = 0; k < 3; k++) {
+					for (int j = 0; j < 3; j++) {
+						evec[(3 * k + j) * N + i] = v[2 - k][j];
+					}
+				}
+			}
+		}
+	}
+}
+template void eig3_sym_batch<double, false>(const double* A, std::int64_t N, double* eval, double* evec);
+template void eig3_sym_batch<float, false>(const float* A, std::int64_t N, float* eval, float* evec);
+template void eig3_sym_batch<double, true>(const double* A, std::int64_t N, double* eval, double* evec);
+template void eig3_sym_batch<float, true>(const float* A, std::int64_t N, float* eval, float* evec);
+
+
+namespace {
+	/**
+	* Scale and shift the general matrix A (row-wise) into B = A / scale - shift * I and solve the characteristic
+	* cubic of B, returning the eigenvalues of A.
+	*/
+	template<typename FP>
+	inline int eig3_general(FP a00, FP a01, FP a02, FP a10, FP a11, FP a12, FP a20, FP a21, FP a22, FP* re, FP* im)
+	{
+		using namespace std;
+		FP scale = (FP)0.0;
+		for (FP a : { a00, a01, a02, a10, a11, a12, a20, a21, a22 }) {
+			scale = abs(a) > scale ? abs(a) : scale;
+		}
+		/* Clamped as in 'eig3_sym_cubic()'. */
+		scale = scale > numeric_limits<FP>::min() ? scale : numeric_limits<FP>::min();
+		FP inv = (FP)1.0 / scale;
+		a00 *= inv; a01 *= inv; a02 *= inv;
+		a10 *= inv; a11 *= inv; a12 *= inv;
+		a20 *= inv; a21 *= inv; a22 *= inv;
+
+		FP shift = (a00 + a11 + a22) * (FP)(1.0 / 3.0);
+		FP b00 = a00 - shift, b11 = a11 - shift, b22 = a22 - shift;
+
+		/* Characteristic equation of a trace free matrix: t^3 + m t - det(B) = 0 */
+		FP m = (b00 * b11 - a01 * a10) + (b00 * b22 - a02 * a20) + (b11 * b22 - a12 * a21);
+		FP det = b00 * (b11 * b22 - a12 * a21) - a01 * (a10 * b22 - a12 * a20) + a02 * (a10 * a21 - b11 * a20);
+		int n = depressed_roots_complex<FP>(m, (FP)-0.5 * det, -shift, re, im);
+		for (int k = 0; k < 3; k++) {
+			re[k] *= scale;
+			im[k] *= scale;
+		}
+		return n;
+	}
+}
+
+
+template<typename FP>
+int eig3(const FP* A, FP* eval_re, FP* eval_im)
+{
+	return eig3_general(A[0], A[1], A[2], A[3], A[4], A[5], A[6], A[7], A[8], eval_re, eval_im);
+}
+template int eig3(const double* A, double* eval_re, double* eval_im);
+template int eig3(const float* A, float* eval_re, float* eval_im);
+
+
+template<typename FP>
+void eig3_batch(const FP* A, std::int64_t N, FP* eval_re, FP* eval_im)
+{
+#pragma omp parallel for schedule(static)
+	for (std::int64_t i = 0; i < N; i++) {
+		FP re[3], im[3];
+		eig3_general(A[i], A[N + i], A[2 * N + i], A[3 * N + i], A[4 * N + i], A[5 * N + i],
+			A[6 * N + i], A[7 * N + i], A[8 * N + i], re, im);
+		for (int k = 0; k < 3; k++) {
+			eval_re[k * N + i] = re[k];
+			eval_im[k * N + i] = im[k];
+		}
+	}
+}
+template void eig3_batch(const double* A, std::int64_t N, double* eval_re, double* eval_im);
+template void eig3_batch(const float* A, std::int64_t N, float* eval_re, float* eval_im);
@@ -0,0 +1,111 @@
+#pragma once
+/* Bounded lock-free multi-producer multi-consumer queue, not part of the public interface.
+*
+* Implementation follows Dmitry Vyukov's bounded MPMC queue: each cell carries a sequence number telling producers
+* and consumers whether the cell is free for the current lap, a single CAS on the enqueue or dequeue position
+* claims the cell.
+*
+* Provided under the Unlicense License (public domain, see license terms at http://unlicense.org/).
+*/
+#include<atomic>
+#include<cstddef>
+#include<memory>
+#include<utility>
+
+
+template<typename T>
+class MPMCQueue {
+public:
+
+	/**
+	* Construct a queue holding at least 'capacity' elements (rounded up to a power of two).
+	*/
+	explicit MPMCQueue(std::size_t capacity)
+	{
+		std::size_t size = 2;
+		while (size < capacity) {
+			size *= 2;
+		}
+		m_mask = size - 1;
+		m_buffer.reset(new Cell[size]);
+		for (std::size_t i = 0; i < size; i++) {
+			m_buffer[i].sequence.store(i, std::memory_order_relaxed);
+		}
+	}
+
+	/**
+	* Push an element, returns false (leaving 'value' untouched) if the queue is full.
+	*/
+	bool try_push(T& value)
+	{
+		Cell* cell;
+		std::size_t pos = m_enqueue_pos.load(std::memory_order_relaxed);
+		for (;;) {
+			cell = &m_buffer[pos & m_mask];
+			std::size_t seq = cell->sequence.load(std::memory_order_acquire);
+			std::ptrdiff_t diff = (std::ptrdiff_t)seq - (std::ptrdiff_t)pos;
+			if (diff == 0) {
+				if (m_enqueue_pos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+					break;
+				}
+			}
+			else if (diff < 0) {
+				return false;
+			}
+			else {
+				pos = m_enqueue_pos.load(std::memory_order_relaxed);
+			}
+		}
+		cell->data = std::move(value);
+		cell->sequence.store(pos + 1, std::memory_order_release);
+		return true;
+	}
+
+	/**
+	* Pop an element, returns false if the queue is empty.
+	*/
+	bool try_pop(T& value)
+	{
+		Cell* cell;
+		std::size_t pos = m_dequeue_pos.load(std::memory_order_relaxed);
+		for (;;) {
+			cell = &m_buffer[pos & m_mask];
+			std::size_t seq = cell->sequence.load(std::memory_order_acquire);
+			std::ptrdiff_t diff = (std::ptrdiff_t)seq - (std::ptrdiff_t)(pos + 1);
+			if (diff == 0) {
+				if (m_dequeue_pos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+					break;
+				}
+			}
+			else if (diff < 0) {
+				return false;
+			}
+			else {
+				pos = m_dequeue_pos.load(std::memory_order_relaxed);
+			}
+		}
+		value = std::move(cell->data);
+		cell->sequence.store(pos + m_mask + 1, std::memory_order_release);
+		return true;
+	}
+
+	/**
+	* Approximate emptiness check, exact only if no push or pop is in flight.
+	*/
+	bool empty() const
+	{
+		return m_enqueue_pos.load(std::memory_order_acquire) == m_dequeue_pos.load(std::memory_order_acquire);
+	}
+
+private:
+	struct Cell {
+		std::atomic<std::size_t> sequence;
+		T data;
+	};
+
+	std::unique_ptr<Cell[]> m_buffer;
+	std::size_t m_mask;
+	/* Positions on separate cache lines to avoid false sharing between producers and consumers. */
+	alignas(64) std::atomic<std::size_t> m_enqueue_pos{ 0 };
+	alignas(64) std::atomic<std::size_t> m_dequeue_pos{ 0 };
+};
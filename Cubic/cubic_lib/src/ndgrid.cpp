@@ -0,0 +1,193 @@
+/* Coordinates of regular N-dimensional grids.
+*
+* Provided under the Unlicense License (public domain, see license terms at http://unlicense.org/).
+*/
+#include "cubic/ndgrid.h"
+
+#include<algorithm>
+#include<cstring>
+
+#ifdef _OPENMP
+#include<omp.h>
+#endif
+
+
+namespace {
+
+	/* Grids with fewer values than this are filled on the calling thread. */
+	constexpr std::int64_t PARALLEL_THRESHOLD = 1 << 16;
+
+	int max_threads()
+	{
+#ifdef _OPENMP
+		return omp_get_max_threads();
+#else
+		return 1;
+#endif
+	}
+
+	/* Output is partitioned over threads in whole tiles of TILE_LINES cache lines. */
+	constexpr std::int64_t CACHE_LINE = (std::int64_t)CACHE_LINE_SIZE;
+	constexpr std::int64_t TILE_LINES = 16;
+
+	constexpr std::int64_t gcd(std::int64_t a, std::int64_t b)
+	{
+		return b == 0 ? a : gcd(b, a % b);
+	}
+
+	/* Smallest number of points filling a whole number of cache lines, times TILE_LINES. */
+	template <typename FP, std::int64_t ndim>
+	constexpr std::int64_t tile_points()
+	{
+		return TILE_LINES * CACHE_LINE / gcd(CACHE_LINE, ndim * (std::int64_t)sizeof(FP));
+	}
+
+	/**
+	 * Fill the grid in parallel over the flattened point index, independent of which dimensions are large. Each
+	 * thread is assigned a contiguous range of whole tiles (thread boundaries fall on cache line boundaries of the
+	 * output), reconstructs the indices of its first point once and streams the rest.
+	 */
+	template <typename FP, std::int64_t ndim>
+	void fill_parallel_tiles(const NdgridView<FP, ndim>& g, FP* data)
+	{
+		constexpr std::int64_t TILE = tile_points<FP, ndim>();
+		const std::int64_t ntiles = (g.size() + TILE - 1) / TILE;
+#pragma omp parallel
+		{
+#ifdef _OPENMP
+			const std::int64_t nthreads = omp_get_num_threads(), tid = omp_get_thread_num();
+#else
+			const std::int64_t nthreads = 1, tid = 0;
+#endif
+			const std::int64_t begin = std::min(g.size(), ntiles * tid / nthreads * TILE);
+			const std::int64_t end = std::min(g.size(), ntiles * (tid + 1) / nthreads * TILE);
+			g.fill(IndexRange(begin, end - begin), data + begin * ndim);
+		}
+	}
+
+	template <typename FP, std::int64_t ndim>
+	void fill_slice_copy(const NdgridView<FP, ndim>& g, FP* data)
+	{
+		if (g.size() == 0) {
+			return;
+		}
+		/* First slice, index 0 along the first dimension. */
+		g.fill(IndexRange(g.strides()[0]), data);
+
+		const std::int64_t slice_size = g.strides()[0] * ndim;
+#pragma omp parallel for schedule(static) if(g.size() * ndim >= PARALLEL_THRESHOLD)
+		for (std::int64_t s = 1; s < g.shape()[0]; s++) {
+			FP* dptr = data + s * slice_size;
+			std::memcpy(static_cast<void*>(dptr), static_cast<const void*>(data), slice_size * sizeof(FP));
+			const FP value = g.coordinate(0, s);
+			for (std::int64_t j = 0; j < slice_size; j += ndim) {
+				dptr[j] = value;
+			}
+		}
+	}
+
+	/* Minimum number of slices per thread for copying slices in parallel. */
+	constexpr std::int64_t MIN_SLICES_PER_THREAD = 4;
+	/* Rows shorter than this are dominated by the per-row overhead, see 'grid_bench'. */
+	constexpr std::int64_t SHORT_ROW = 16;
+
+	/* Choose the strategy from the 'grid_bench' timings. */
+	template <typename FP, std::int64_t ndim>
+	NdgridStrategy select_strategy(const NdgridView<FP, ndim>& g)
+	{
+		const std::int64_t nthreads = max_threads();
+		/* Copying slices avoids the per-row cost of short rows, but costs a read pass for long rows. */
+		const bool copy_slices = g.shape()[ndim - 1] < SHORT_ROW && g.shape()[0] > 1;
+		if (nthreads == 1 || g.size() * ndim < PARALLEL_THRESHOLD) {
+			return copy_slices ? NdgridStrategy::SLICE_COPY : NdgridStrategy::ROWS;
+		}
+		return copy_slices && g.shape()[0] >= MIN_SLICES_PER_THREAD * nthreads ?
+			NdgridStrategy::SLICE_COPY : NdgridStrategy::PARALLEL_TILES;
+	}
+}
+
+
+template <typename FP, std::int64_t ndim>
+AlignedBuffer<FP> ndgrid(const NdgridView<FP, ndim>& g, NdgridStrategy strategy, const AllocConfig& alloc)
+{
+	AlignedBuffer<FP> buffer(g.size() * ndim, alloc);
+	FP* data = buffer.data();
+
+	if (strategy == NdgridStrategy::AUTO) {
+		strategy = select_strategy(g);
+	}
+	switch (strategy) {
+	case NdgridStrategy::SLICE_COPY:
+		fill_slice_copy(g, data);
+		break;
+	case NdgridStrategy::PARALLEL_TILES:
+		fill_parallel_tiles(g, data);
+		break;
+	default:
+		g.fill(g.range(), data);
+		break;
+	}
+	return buffer;
+}
+template AlignedBuffer<float> ndgrid(const NdgridView<float, 2>& grid, NdgridStrategy strategy, const AllocConfig& alloc);
+template AlignedBuffer<float> ndgrid(const NdgridView<float, 3>& grid, NdgridStrategy strategy, const AllocConfig& alloc);
+template AlignedBuffer<float> ndgrid(const NdgridView<float, 4>& grid, NdgridStrategy strategy, const AllocConfig& alloc);
+template AlignedBuffer<double> ndgrid(const NdgridView<double, 2>& grid, NdgridStrategy strategy, const AllocConfig& alloc);
+template AlignedBuffer<double> ndgrid(const NdgridView<double, 3>& grid, NdgridStrategy strategy, const AllocConfig& alloc);
+template AlignedBuffer<double> ndgrid(const NdgridView<double, 4>& grid, NdgridStrategy strategy, const AllocConfig& alloc);
+
+template <typename FP, std::int64_t ndim>
+AlignedBuffer<FP> ndgrid(std::array<std::int64_t, ndim> shape, std::array<FP, ndim> size, NdgridStrategy strategy, const AllocConfig& alloc)
+{
+	return ndgrid(NdgridView<FP, ndim>(shape, size), strategy, alloc);
+}
+template AlignedBuffer<float> ndgrid<float, 2>(std::array<std::int64_t, 2> shape, std::array<float, 2> size, NdgridStrategy strategy, const AllocConfig& alloc);
+template AlignedBuffer<float> ndgrid<float, 3>(std::array<std::int64_t, 3> shape, std::array<float, 3> size, NdgridStrategy strategy, const AllocConfig& alloc);
+template AlignedBuffer<float> ndgrid<float, 4>(std::array<std::int64_t, 4> shape, std::array<float, 4> size, NdgridStrategy strategy, const AllocConfig& alloc);
+template AlignedBuffer<double> ndgrid<double, 2>(std::array<std::int64_t, 2> shape, std::array<double, 2> size, NdgridStrategy strategy, const AllocConfig& alloc);
+template AlignedBuffer<double> ndgrid<double, 3>(std::array<std::int64_t, 3> shape, std::array<double, 3> size, NdgridStrategy strategy, const AllocConfig& alloc);
+template AlignedBuffer<double> ndgrid<double, 4>(std::array<std::int64_t, 4> shape, std::array<double, 4> size, NdgridStrategy strategy, const AllocConfig& alloc);
+
+template <typename FP, std::int64_t ndim>
+NdgridPlanes<FP, ndim> ndgrid_planes(const NdgridView<FP, ndim>& g, const AllocConfig& alloc)
+{
+	/* Pad planes to whole cache lines, keeping each plane aligned. */
+	constexpr std::int64_t LINE = CACHE_LINE / (std::int64_t)sizeof(FP);
+	const std::int64_t stride = (g.size() + LINE - 1) / LINE * LINE;
+	AlignedBuffer<FP> buffer(ndim * stride, alloc);
+	FP* data = buffer.data();
+
+	/* Each thread fills the same cache line aligned range of points in every plane. */
+	constexpr std::int64_t TILE = TILE_LINES * LINE;
+	const std::int64_t ntiles = (g.size() + TILE - 1) / TILE;
+#pragma omp parallel if(g.size() * ndim >= PARALLEL_THRESHOLD)
+	{
+#ifdef _OPENMP
+		const std::int64_t nthreads = omp_get_num_threads(), tid = omp_get_thread_num();
+#else
+		const std::int64_t nthreads = 1, tid = 0;
+#endif
+		const std::int64_t begin = std::min(g.size(), ntiles * tid / nthreads * TILE);
+		const std::int64_t end = std::min(g.size(), ntiles * (tid + 1) / nthreads * TILE);
+		g.fill_planes(IndexRange(begin, end - begin), data + begin, stride);
+	}
+	return NdgridPlanes<FP, ndim>(std::move(buffer), g.size(), stride);
+}
+template NdgridPlanes<float, 2> ndgrid_planes(const NdgridView<float, 2>& grid, const AllocConfig& alloc);
+template NdgridPlanes<float, 3> ndgrid_planes(const NdgridView<float, 3>& grid, const AllocConfig& alloc);
+template NdgridPlanes<float, 4> ndgrid_planes(const NdgridView<float, 4>& grid, const AllocConfig& alloc);
+template NdgridPlanes<double, 2> ndgrid_planes(const NdgridView<double, 2>& grid, const AllocConfig& alloc);
+template NdgridPlanes<double, 3> ndgrid_planes(const NdgridView<double, 3>& grid, const AllocConfig& alloc);
+template NdgridPlanes<double, 4> ndgrid_planes(const NdgridView<double, 4>& grid, const AllocConfig& alloc);
+
+template <typename FP, std::int64_t ndim>
+NdgridPlanes<FP, ndim> ndgrid_planes(std::array<std::int64_t, ndim> shape, std::array<FP, ndim> size, const AllocConfig& alloc)
+{
+	return ndgrid_planes(NdgridView<FP, ndim>(shape, size), alloc);
+}
+template NdgridPlanes<float, 2> ndgrid_planes<float, 2>(std::array<std::int64_t, 2> shape, std::array<float, 2> size, const AllocConfig& alloc);
+template NdgridPlanes<float, 3> ndgrid_planes<float, 3>(std::array<std::int64_t, 3> shape, std::array<float, 3> size, const AllocConfig& alloc);
+template NdgridPlanes<float, 4> ndgrid_planes<float, 4>(std::array<std::int64_t, 4> shape, std::array<float, 4> size, const AllocConfig& alloc);
+template NdgridPlanes<double, 2> ndgrid_planes<double, 2>(std::array<std::int64_t, 2> shape, std::array<double, 2> size, const AllocConfig& alloc);
+template NdgridPlanes<double, 3> ndgrid_planes<double, 3>(std::array<std::int64_t, 3> shape, std::array<double, 3> size, const AllocConfig& alloc);
+template NdgridPlanes<double, 4> ndgrid_planes<double, 4>(std::array<std::int64_t, 4> shape, std::array<double, 4> size, const AllocConfig& alloc);
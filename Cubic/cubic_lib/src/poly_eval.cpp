@@ -0,0 +1,142 @@
+/* Batch evaluation of cubic and quadratic polynomials.
+*
+* Provided under the Unlicense License (public domain, see license terms at http://unlicense.org/).
+*/
+#include "cubic/poly_eval.h"
+#include "cubic/eft.h"
+
+#include<cmath>
+
+
+namespace {
+
+	/* Evaluations below this count run on the calling thread. */
+	constexpr std::int64_t PARALLEL_THRESHOLD = 1 << 16;
+
+	/* a * b + c, fused if the target has hardware FMA (std::fma() is emulated in software otherwise). */
+	template<typename FP>
+	inline FP madd(FP a, FP b, FP c)
+	{
+#if defined(FP_FAST_FMA) || defined(__FMA__) || defined(__AVX2__)
+		return std::fma(a, b, c);
+#else
+		return a * b + c;
+#endif
+	}
+
+	/**
+	* Evaluate the cubic with coefficients coeffs(i, a, b, c, d) at x[i], optionally fused with the derivative
+	* (DERIV) and compensated (COMP).
+	*/
+	template<typename FP, bool DERIV, bool COMP, typename Coeffs>
+	void cubic_eval_kernel(Coeffs coeffs, const FP* x, std::int64_t N, FP* f, FP* df)
+	{
+#pragma omp parallel for simd schedule(static) if(N >= PARALLEL_THRESHOLD)
+		for (std::int64_t i = 0; i < N; i++) {
+			FP a, b, c, d;
+			coeffs(i, a, b, c, d);
+			const FP xi = x[i];
+			FP p1 = madd(a, xi, b);
+			FP p2 = madd(p1, xi, c);
+			if constexpr (COMP) {
+				f[i] = cubic_compensated(a, b, c, d, xi);
+			}
+			else {
+				f[i] = madd(p2, xi, d);
+			}
+			if constexpr (DERIV) {
+				/* (3ax + 2b)x + c = ((ax + p1)x + p2) */
+				df[i] = madd(madd(a, xi, p1), xi, p2);
+			}
+		}
+	}
+
+	template<typename FP, bool DERIV, bool COMP, typename Coeffs>
+	void quadratic_eval_kernel(Coeffs coeffs, const FP* x, std::int64_t N, FP* f, FP* df)
+	{
+#pragma omp parallel for simd schedule(static) if(N >= PARALLEL_THRESHOLD)
+		for (std::int64_t i = 0; i < N; i++) {
+			FP a, b, c;
+			coeffs(i, a, b, c);
+			const FP xi = x[i];
+			FP p1 = madd(a, xi, b);
+			if constexpr (COMP) {
+				f[i] = quadratic_compensated(a, b, c, xi);
+			}
+			else {
+				f[i] = madd(p1, xi, c);
+			}
+			if constexpr (DERIV) {
+				/* 2ax + b = ax + p1 */
+				df[i] = madd(a, xi, p1);
+			}
+		}
+	}
+
+	template<typename FP, typename Coeffs>
+	void cubic_eval_dispatch(Coeffs coeffs, const FP* x, std::int64_t N, FP* f, FP* df, bool compensated)
+	{
+		if (compensated) {
+			df ? cubic_eval_kernel<FP, true, true>(coeffs, x, N, f, df) : cubic_eval_kernel<FP, false, true>(coeffs, x, N, f, df);
+		}
+		else {
+			df ? cubic_eval_kernel<FP, true, false>(coeffs, x, N, f, df) : cubic_eval_kernel<FP, false, false>(coeffs, x, N, f, df);
+		}
+	}
+
+	template<typename FP, typename Coeffs>
+	void quadratic_eval_dispatch(Coeffs coeffs, const FP* x, std::int64_t N, FP* f, FP* df, bool compensated)
+	{
+		if (compensated) {
+			df ? quadratic_eval_kernel<FP, true, true>(coeffs, x, N, f, df) : quadratic_eval_kernel<FP, false, true>(coeffs, x, N, f, df);
+		}
+		else {
+			df ? quadratic_eval_kernel<FP, true, false>(coeffs, x, N, f, df) : quadratic_eval_kernel<FP, false, false>(coeffs, x, N, f, df);
+		}
+	}
+}
+
+
+template<typename FP>
+void cubic_eval_soa(const FP* a, const FP* b, const FP* c, const FP* d, const FP* x, std::int64_t N, FP* f, FP* df, bool compensated)
+{
+	auto coeffs = [=](std::int64_t i, FP& ai, FP& bi, FP& ci, FP& di) {
+		ai = a[i]; bi = b[i]; ci = c[i]; di = d[i];
+	};
+	cubic_eval_dispatch<FP>(coeffs, x, N, f, df, compensated);
+}
+template void cubic_eval_soa(const double* a, const double* b, const double* c, const double* d, const double* x, std::int64_t N, double* f, double* df, bool compensated);
+template void cubic_eval_soa(const float* a, const float* b, const float* c, const float* d, const float* x, std::int64_t N, float* f, float* df, bool compensated);
+
+template<typename FP>
+void cubic_eval_points(FP a, FP b, FP c, FP d, const FP* x, std::int64_t N, FP* f, FP* df, bool compensated)
+{
+	auto coeffs = [=](std::int64_t, FP& ai, FP& bi, FP& ci, FP& di) {
+		ai = a; bi = b; ci = c; di = d;
+	};
+	cubic_eval_dispatch<FP>(coeffs, x, N, f, df, compensated);
+}
+template void cubic_eval_points(double a, double b, double c, double d, const double* x, std::int64_t N, double* f, double* df, bool compensated);
+template void cubic_eval_points(float a, float b, float c, float d, const float* x, std::int64_t N, float* f, float* df, bool compensated);
+
+template<typename FP>
+void quadratic_eval_soa(const FP* a, const FP* b, const FP* c, const FP* x, std::int64_t N, FP* f, FP* df, bool compensated)
+{
+	auto coeffs = [=](std::int64_t i, FP& ai, FP& bi, FP& ci) {
+		ai = a[i]; bi = b[i]; ci = c[i];
+	};
+	quadratic_eval_dispatch<FP>(coeffs, x, N, f, df, compensated);
+}
+template void quadratic_eval_soa(const double* a, const double* b, const double* c, const double* x, std::int64_t N, double* f, double* df, bool compensated);
+template void quadratic_eval_soa(const float* a, const float* b, const float* c, const float* x, std::int64_t N, float* f, float* df, bool compensated);
+
+template<typename FP>
+void quadratic_eval_points(FP a, FP b, FP c, const FP* x, std::int64_t N, FP* f, FP* df, bool compensated)
+{
+	auto coeffs = [=](std::int64_t, FP& ai, FP& bi, FP& ci) {
+		ai = a; bi = b; ci = c;
+	};
+	quadratic_eval_dispatch<FP>(coeffs, x, N, f, df, compensated);
+}
+template void quadratic_eval_points(double a, double b, double c, const double* x, std::int64_t N, double* f, double* df, bool compensated);
+template void quadratic_eval_points(float a, float b, float c, const float* x, std::int64_t N, float* f, float* df, bool compensated);
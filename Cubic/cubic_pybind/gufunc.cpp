@@ -0,0 +1,126 @@
+/* NumPy generalized ufuncs for the root solvers.
+*
+* The gufuncs operate on the last axis of the input and broadcast over any leading dimensions:
+*
+*	cubic_roots		(4)->(3),()		coefficients [a, b, c, d] -> roots padded with NaN, number of real roots
+*	quadratic_roots	(3)->(2),()		coefficients [a, b, c] -> roots padded with NaN, number of real roots
+*	qdrtc			(3)->(2),()
+*
+* with loops for float32 and float64 (roots have the input dtype, counts are int32). Being ufuncs they honor out=,
+* where= and the __array_ufunc__ protocol (xarray.apply_ufunc, dask.array.gufunc etc.).
+*/
+#define NPY_NO_DEPRECATED_API NPY_1_7_API_VERSION
+#include "gufunc.h"
+
+#include <numpy/arrayobject.h>
+#include <numpy/ufuncobject.h>
+
+#include <cubic/cubic.h>
+
+#include <limits>
+
+
+namespace py = pybind11;
+
+namespace {
+
+	template<typename FP, CBRT_SOLVER<FP> solver>
+	int cubic_adapter(const FP* A, FP* xroots)
+	{
+		return solver(A[0], A[1], A[2], A[3], xroots);
+	}
+
+	template<typename FP, QDRT_SOLVER<FP> solver>
+	int quadratic_adapter(const FP* A, FP* xroots)
+	{
+		return solver(A[0], A[1], A[2], xroots);
+	}
+
+	/* Inner loop of a (NCOEFF)->(NCOEFF - 1),() gufunc, strided over the outer loop and the core dimensions. */
+	template<typename FP, int NCOEFF, int(*solver)(const FP*, FP*)>
+	void roots_loop(char** args, npy_intp const* dimensions, npy_intp const* steps, void*)
+	{
+		constexpr int NROOTS = NCOEFF - 1;
+		const npy_intp N = dimensions[0];
+		char* in = args[0];
+		char* roots = args[1];
+		char* count = args[2];
+		/* Outer strides of the operands followed by the core strides of the input and the roots. */
+		const npy_intp in_step = steps[0], roots_step = steps[1], count_step = steps[2];
+		const npy_intp in_core = steps[3], roots_core = steps[4];
+		FP A[NCOEFF], xroots[NROOTS];
+		for (npy_intp i = 0; i < N; i++) {
+			for (int k = 0; k < NCOEFF; k++) {
+				A[k] = *reinterpret_cast<const FP*>(in + k * in_core);
+			}
+			const int n = solver(A, xroots);
+			for (int k = 0; k < NROOTS; k++) {
+				*reinterpret_cast<FP*>(roots + k * roots_core) = k < n ? xroots[k] : std::numeric_limits<FP>::quiet_NaN();
+			}
+			*reinterpret_cast<npy_int*>(count) = n;
+			in += in_step;
+			roots += roots_step;
+			count += count_step;
+		}
+	}
+
+	/* Loops and type signatures (input, roots, count) of one gufunc, float32 then float64. */
+	struct GufuncLoops {
+		PyUFuncGenericFunction funcs[2];
+		void* data[2];
+		char types[6];
+	};
+
+	template<int NCOEFF, int(*float_solver)(const float*, float*), int(*double_solver)(const double*, double*)>
+	GufuncLoops* loops()
+	{
+		/* Referenced by the ufunc for the lifetime of the module. */
+		static GufuncLoops l = {
+			{ &roots_loop<float, NCOEFF, float_solver>, &roots_loop<double, NCOEFF, double_solver> },
+			{ nullptr, nullptr },
+			{ NPY_FLOAT, NPY_FLOAT, NPY_INT, NPY_DOUBLE, NPY_DOUBLE, NPY_INT },
+		};
+		return &l;
+	}
+
+	py::object make_gufunc(GufuncLoops* l, const char* name, const char* doc, const char* signature)
+	{
+		PyObject* ufunc = PyUFunc_FromFuncAndDataAndSignature(l->funcs, l->data, l->types, 2, 1, 2, PyUFunc_None,
+			name, doc, 0, signature);
+		if (!ufunc) {
+			throw py::error_already_set();
+		}
+		return py::reinterpret_steal<py::object>(ufunc);
+	}
+}
+
+
+void register_gufuncs(py::module& m)
+{
+	if (_import_array() < 0 || _import_umath() < 0) {
+		throw py::error_already_set();
+	}
+	py::module g = m.def_submodule("gufunc", "NumPy generalized ufuncs of the root solvers.");
+
+	g.attr("cubic_roots") = make_gufunc(
+		loops<4, &cubic_adapter<float, &cubic_roots<float>>, &cubic_adapter<double, &cubic_roots<double>>>(),
+		"cubic_roots",
+		"cubic_roots(coeffs) -> (roots, nroots)\n\n"
+		"Real roots of the cubic equations with coefficients [a, b, c, d] along the last axis. Roots are padded with "
+		"NaN to shape (..., 3), nroots holds the number of real roots.",
+		"(4)->(3),()");
+	g.attr("quadratic_roots") = make_gufunc(
+		loops<3, &quadratic_adapter<float, &quadratic_roots<float>>, &quadratic_adapter<double, &quadratic_roots<double>>>(),
+		"quadratic_roots",
+		"quadratic_roots(coeffs) -> (roots, nroots)\n\n"
+		"Real roots of the quadratic equations with coefficients [a, b, c] along the last axis. Roots are padded "
+		"with NaN to shape (..., 2), nroots holds the number of real roots.",
+		"(3)->(2),()");
+	g.attr("qdrtc") = make_gufunc(
+		loops<3, &quadratic_adapter<float, &qdrtc<float>>, &quadratic_adapter<double, &qdrtc<double>>>(),
+		"qdrtc",
+		"qdrtc(coeffs) -> (roots, nroots)\n\n"
+		"Real roots of the quadratic equations with coefficients [a, b, c] along the last axis using Kahan's "
+		"qdrtc. Roots are padded with NaN to shape (..., 2), nroots holds the number of real roots.",
+		"(3)->(2),()");
+}
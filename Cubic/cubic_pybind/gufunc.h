@@ -0,0 +1,7 @@
+#pragma once
+/* NumPy generalized ufuncs for the root solvers.
+*/
+#include <pybind11/pybind11.h>
+
+/* Register the gufuncs in a 'gufunc' submodule of m. */
+void register_gufuncs(pybind11::module& m);
@@ -3,8 +3,19 @@
 #include <pybind11/pybind11.h>
 #include <pybind11/stl.h>
 #include <pybind11/pybind11.h>
+#include <pybind11/numpy.h>
 
 #include <cubic/cubic.h>
+#include <cubic/cubic_batch.h>
+
+#include <cubic/cubic_c.h>
+
+#include "gufunc.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <limits>
+#include <string>
 
 
 #ifndef PROJECT_NAME_DEF
@@ -50,6 +61,110 @@ std::vector<FP> quadratic_roots_bind(FP a, FP b, FP c) {
 
 namespace py = pybind11;
 
+/* C-contiguous array of FP, other layouts or dtypes are converted on cast. */
+template<typename FP>
+using CARRAY = py::array_t<FP, py::array::c_style | py::array::forcecast>;
+
+/* Cast to a C-contiguous array of FP, 'ensure()' clears the Python error and returns null if the conversion fails. */
+template<typename FP>
+static CARRAY<FP> ensure_carray(const py::array& coeffs) {
+	CARRAY<FP> data = CARRAY<FP>::ensure(coeffs);
+	if (!data) {
+		throw py::type_error("Coefficient array is not convertible to " + std::string(py::str(py::dtype::of<FP>())) + ".");
+	}
+	return data;
+}
+
+/* Check and return the number of equations in an (N, ncoeff) coefficient array. */
+static std::int64_t num_equations(const py::array& coeffs, py::ssize_t ncoeff) {
+	if (coeffs.ndim() != 2 || coeffs.shape(1) != ncoeff) {
+		throw std::invalid_argument("Coefficient array must have shape (N, " + std::to_string(ncoeff) + ").");
+	}
+	return coeffs.shape(0);
+}
+
+/* Batch bind function returning roots in CSR form: (roots, offsets) where the roots of the i:th
+* polynomial are roots[offsets[i]:offsets[i + 1]].
+*/
+template<typename FP, CBRT_SOLVER<FP> solver>
+py::tuple cubic_roots_csr_bind(const CARRAY<FP>& coeffs) {
+	const std::int64_t N = num_equations(coeffs, 4);
+
+	py::array_t<std::int64_t> offsets(N + 1);
+	std::vector<FP>* roots = new std::vector<FP>();
+	{
+		py::gil_scoped_release release;
+		cubic_roots_csr<FP>(coeffs.data(), N, *roots, offsets.mutable_data(), solver);
+	}
+	/* Hand the root buffer over to numpy without copying. */
+	py::capsule owner(roots, [](void* p) { delete reinterpret_cast<std::vector<FP>*>(p); });
+	py::array_t<FP> out((py::ssize_t)roots->size(), roots->data(), owner);
+	return py::make_tuple(out, offsets);
+}
+
+/* Batch bind function returning (roots, nroots): roots of the i:th polynomial are roots[i, :nroots[i]], remaining
+* elements of the (N, 3) array are NaN.
+*/
+template<typename FP, CBRT_SOLVER<FP> solver>
+py::tuple cubic_roots_batch_bind(const CARRAY<FP>& coeffs) {
+	const std::int64_t N = num_equations(coeffs, 4);
+
+	py::array_t<FP> roots({ (py::ssize_t)N, (py::ssize_t)3 });
+	py::array_t<int> nroots(N);
+	{
+		py::gil_scoped_release release;
+		FP* x = roots.mutable_data();
+		std::fill(x, x + 3 * N, std::numeric_limits<FP>::quiet_NaN());
+		cubic_roots_batch<FP>(coeffs.data(), N, x, nroots.mutable_data(), solver);
+	}
+	return py::make_tuple(roots, nroots);
+}
+
+/* Dispatch a batch bind function on the dtype of the coefficients: float32 arrays are solved in single precision
+* and float64 arrays in double precision, both without conversion if C-contiguous. Other dtypes are converted to
+* float64. Output arrays have the dtype solved in.
+*/
+template<py::tuple(*bind_float)(const CARRAY<float>&), py::tuple(*bind_double)(const CARRAY<double>&)>
+py::tuple dtype_dispatch(const py::array& coeffs) {
+	/* Compares the dtype by value, dtype objects equal to float32 need not be the same instance. */
+	if (py::isinstance<py::array_t<float>>(coeffs)) {
+		return bind_float(ensure_carray<float>(coeffs));
+	}
+	return bind_double(ensure_carray<double>(coeffs));
+}
+
+/* Address and cffi style C signature of an entry point in 'cubic_c.h'. */
+template<typename F>
+py::tuple c_entry(F* f, const char* signature) {
+	return py::make_tuple(reinterpret_cast<std::uintptr_t>(f), signature);
+}
+
+/* Table of the C entry points, name -> (address, signature). */
+static py::dict c_api() {
+	const char* cbrt_d = "int(double, double, double, double, double*)";
+	const char* cbrt_f = "int(float, float, float, float, float*)";
+	const char* qdrt_d = "int(double, double, double, double*)";
+	const char* qdrt_f = "int(float, float, float, float*)";
+	const char* batch_d = "void(const double*, int64_t, double*, int*)";
+	const char* batch_f = "void(const float*, int64_t, float*, int*)";
+	py::dict api;
+	api["cubic_roots_d"] = c_entry(&cubic_roots_d, cbrt_d);
+	api["cubic_roots_f"] = c_entry(&cubic_roots_f, cbrt_f);
+	api["cubic_roots_fast_d"] = c_entry(&cubic_roots_fast_d, cbrt_d);
+	api["cubic_roots_fast_f"] = c_entry(&cubic_roots_fast_f, cbrt_f);
+	api["cubic_roots_qbc_d"] = c_entry(&cubic_roots_qbc_d, cbrt_d);
+	api["cubic_roots_qbc_f"] = c_entry(&cubic_roots_qbc_f, cbrt_f);
+	api["quadratic_roots_d"] = c_entry(&quadratic_roots_d, qdrt_d);
+	api["quadratic_roots_f"] = c_entry(&quadratic_roots_f, qdrt_f);
+	api["qdrtc_d"] = c_entry(&qdrtc_d, qdrt_d);
+	api["qdrtc_f"] = c_entry(&qdrtc_f, qdrt_f);
+	api["cubic_roots_batch_d"] = c_entry(&cubic_roots_batch_d, batch_d);
+	api["cubic_roots_batch_f"] = c_entry(&cubic_roots_batch_f, batch_f);
+	api["cubic_roots_qbc_batch_d"] = c_entry(&cubic_roots_qbc_batch_d, batch_d);
+	api["cubic_roots_qbc_batch_f"] = c_entry(&cubic_roots_qbc_batch_f, batch_f);
+	return api;
+}
+
 PYBIND11_MODULE(PROJECT_NAME_DEF, m) {
 	m.doc() = R"pbdoc(
         Cubic solver pybinds
@@ -58,7 +173,12 @@ PYBIND11_MODULE(PROJECT_NAME_DEF, m) {
         .. autosummary::
            :toctree: _generate
            cubic_roots
+		   cubic_roots_fast
 		   quadratic_roots
+		   cubic_roots_csr
+		   cubic_roots_batch
+		   gufunc
+		   c_api
     )pbdoc";
 
 	m.def("cubic_roots", &cubic_roots_bind<double, &cubic_roots<double>>, R"pbdoc(
@@ -69,6 +189,10 @@ PYBIND11_MODULE(PROJECT_NAME_DEF, m) {
     )pbdoc");
 
 
+	m.def("cubic_roots_fast", &cubic_roots_bind<double, &cubic_roots_fast<double>>, R"pbdoc(
+        Compute the real roots for the cubic equation using fast (bounded error) approximations of acos, cos and cbrt.
+    )pbdoc");
+
 	m.def("cubic_roots_qbc", &cubic_roots_bind<double, &cubic_roots_qbc<double>>, R"pbdoc(
         Compute the real roots for the cubic equation.
     )pbdoc");
@@ -77,6 +201,31 @@ PYBIND11_MODULE(PROJECT_NAME_DEF, m) {
         Compute the real roots for the cubic equation.
     )pbdoc");
 
+	m.def("cubic_roots_csr", &dtype_dispatch<&cubic_roots_csr_bind<float, &cubic_roots<float>>, &cubic_roots_csr_bind<double, &cubic_roots<double>>>, R"pbdoc(
+        Compute the real roots for an (N, 4) array of cubic equations (float32 or float64).
+        Returns (roots, offsets) where roots[offsets[i]:offsets[i + 1]] are the roots of the i:th equation.
+    )pbdoc");
+	m.def("cubic_roots_qbc_csr", &dtype_dispatch<&cubic_roots_csr_bind<float, &cubic_roots_qbc<float>>, &cubic_roots_csr_bind<double, &cubic_roots_qbc<double>>>, R"pbdoc(
+        Compute the real roots for an (N, 4) array of cubic equations (float32 or float64) using QBC.
+        Returns (roots, offsets) where roots[offsets[i]:offsets[i + 1]] are the roots of the i:th equation.
+    )pbdoc");
+	m.def("cubic_roots_batch", &dtype_dispatch<&cubic_roots_batch_bind<float, &cubic_roots<float>>, &cubic_roots_batch_bind<double, &cubic_roots<double>>>, R"pbdoc(
+        Compute the real roots for an (N, 4) array of cubic equations (float32 or float64).
+        Returns (roots, nroots) where roots[i, :nroots[i]] are the roots of the i:th equation, padded with NaN.
+    )pbdoc");
+	m.def("cubic_roots_fast_batch", &dtype_dispatch<&cubic_roots_batch_bind<float, &cubic_roots_fast<float>>, &cubic_roots_batch_bind<double, &cubic_roots_fast<double>>>, R"pbdoc(
+        Compute the real roots for an (N, 4) array of cubic equations (float32 or float64) using fast approximations.
+        Returns (roots, nroots) where roots[i, :nroots[i]] are the roots of the i:th equation, padded with NaN.
+    )pbdoc");
+
+	register_gufuncs(m);
+
+	/* C entry points for numba / cffi / ctypes, e.g. with cffi:
+	*	address, signature = cubic.c_api["cubic_roots_qbc_d"]
+	*	solve = ffi.cast(signature.replace("(", "(*)(", 1), address)
+	*/
+	m.attr("c_api") = c_api();
+
 #ifdef VERSION_INFO
 	m.attr("__version__") = MACRO_STRINGIFY(VERSION_INFO);
 #else
@@ -19,6 +19,13 @@ def cubic_solve(A):
     roots = np.sort(roots)
     return roots, cubic_sum(A, roots)
 
+def cubic_fast_solve(A):
+    """
+    """
+    roots = cubic.cubic_roots_fast(*A)
+    roots = np.sort(roots)
+    return roots, cubic_sum(A, roots)
+
 def cubic_qbc_solve(A):
     """
     """
@@ -55,9 +62,10 @@ def run_algo_comparison(max=1e5, N=10000, N_runs=1, seed=5098359162415):
     iter = 0
     while (iter < N_runs):
         polys = rng.uniform(-max, max, (N, 4))
-        csums, qbcsums, npsums = [], [], []
+        csums, fsums, qbcsums, npsums = [], [], [], []
         for i, A in enumerate(polys):
             croots, csum = cubic_solve(A)
+            froots, fsum = cubic_fast_solve(A)
             qbcroots, qbcsum = cubic_qbc_solve(A)
             nproots, npsum = numpy_solve(A)
                 
@@ -67,16 +75,22 @@ def run_algo_comparison(max=1e5, N=10000, N_runs=1, seed=5098359162415):
             if len(qbcroots) != len(nproots):
                 print("'qbc': Mismatch in number of roots for polynom %s | Out: %s | Ans: %s" % (str(A), str(croots), str(nproots)))
 
+            if len(froots) != len(nproots):
+                print("'fast': Mismatch in number of roots for polynom %s | Out: %s | Ans: %s" % (str(A), str(froots), str(nproots)))
+
             csums.extend(csum)
+            fsums.extend(fsum)
             qbcsums.extend(qbcsum)
             npsums.extend(npsum)
 
         acsums = np.abs(csums)
+        afsums = np.abs(fsums)
         aqbcsums = np.abs(qbcsums)
         anpsums = np.abs(npsums)
         print("Algorithm comparison | Run %i | N %i | Max %.2E:" % (iter, N, max))
         # Mean absolute error
         print("Cubic solver | MAE: %0.16f | MAE Std: %0.16f | EMax: %0.16f" % (np.mean(acsums), np.std(acsums), np.max(acsums)))
+        print("Fast solver | MAE: %0.16f | MAE Std: %0.16f | EMax: %0.16f" % (np.mean(afsums), np.std(afsums), np.max(afsums)))
         print("QBC solver | MAE: %0.16f | MAE Std: %0.16f | EMax: %0.16f" % (np.mean(aqbcsums), np.std(aqbcsums), np.max(aqbcsums)))
         print("Numpy solver | MAE: %0.16f | MAE Std: %0.16f | EMax: %0.16f" % (np.mean(anpsums), np.std(anpsums), np.max(anpsums)))
         iter += 1
@@ -117,6 +131,79 @@ class Unittest(unittest.TestCase):
         verif_cbrt_solver_uniform(cubic_qbc_solve)
         
     
+    def test_csr(self):
+        rng = np.random.default_rng(5098359162415)
+        polys = rng.uniform(-1e0, 1e0, (10000, 4))
+        for csr_solver, cbrt_solver in ((cubic.cubic_roots_csr, cubic.cubic_roots),
+                                        (cubic.cubic_roots_qbc_csr, cubic.cubic_roots_qbc)):
+            roots, offsets = csr_solver(polys)
+            assert offsets.shape == (len(polys) + 1,) and offsets[-1] == len(roots)
+            for i, A in enumerate(polys):
+                assert np.array_equal(roots[offsets[i]:offsets[i + 1]], cbrt_solver(*A)), \
+                    "%i:th failed for polynom %s" % (i, str(A))
+
+    def test_batch_dtype(self):
+        rng = np.random.default_rng(5098359162415)
+        polys = rng.uniform(-1e0, 1e0, (10000, 4))
+        for dtype in (np.float32, np.float64):
+            A = polys.astype(dtype)
+            roots, nroots = cubic.cubic_roots_batch(A)
+            csr_roots, offsets = cubic.cubic_roots_csr(A)
+            assert roots.dtype == dtype and csr_roots.dtype == dtype and roots.shape == (len(A), 3)
+            assert np.array_equal(np.diff(offsets), nroots)
+            for i in range(len(A)):
+                assert np.array_equal(roots[i, :nroots[i]], csr_roots[offsets[i]:offsets[i + 1]]), \
+                    "%i:th failed for polynom %s" % (i, str(A[i]))
+                assert np.all(np.isnan(roots[i, nroots[i]:]))
+        # Other dtypes are solved in float64
+        roots, nroots = cubic.cubic_roots_batch((polys * 10).astype(np.int32))
+        assert roots.dtype == np.float64
+        # float32 dtypes equal to but not the same instance as np.dtype(np.float32)
+        roots, nroots = cubic.cubic_roots_batch(polys.astype(np.dtype(np.float32, metadata={"unit": "m"})))
+        assert roots.dtype == np.float32
+        with self.assertRaises(TypeError):
+            cubic.cubic_roots_batch(np.full((2, 4), "x"))
+
+    def test_gufunc(self):
+        rng = np.random.default_rng(5098359162415)
+        polys = rng.uniform(-1e0, 1e0, (20, 50, 4))
+        roots, nroots = cubic.gufunc.cubic_roots(polys)
+        assert roots.shape == (20, 50, 3) and nroots.shape == (20, 50)
+        for idx in np.ndindex(nroots.shape):
+            expected = cubic.cubic_roots(*polys[idx])
+            assert nroots[idx] == len(expected) and np.array_equal(roots[idx][:nroots[idx]], expected), \
+                "%s:th failed for polynom %s" % (str(idx), str(polys[idx]))
+            assert np.all(np.isnan(roots[idx][nroots[idx]:]))
+        # out= and float32 loop
+        out = (np.empty((20, 50, 3), np.float32), np.empty((20, 50), np.int32))
+        result = cubic.gufunc.cubic_roots(polys.astype(np.float32), out=out)
+        assert result[0] is out[0] and result[1] is out[1]
+        # Quadratic
+        roots, nroots = cubic.gufunc.qdrtc(polys[..., :3])
+        for idx in np.ndindex(nroots.shape):
+            assert np.array_equal(roots[idx][:nroots[idx]], cubic.qdrtc(*polys[idx][:3]))
+
+    def test_c_api(self):
+        import ctypes
+        rng = np.random.default_rng(5098359162415)
+        polys = rng.uniform(-1e0, 1e0, (1000, 4))
+        address, signature = cubic.c_api["cubic_roots_qbc_d"]
+        assert signature == "int(double, double, double, double, double*)"
+        solve = ctypes.CFUNCTYPE(ctypes.c_int, *[ctypes.c_double] * 4, ctypes.POINTER(ctypes.c_double))(address)
+        x = (ctypes.c_double * 3)()
+        for A in polys:
+            n = solve(*A, x)
+            assert np.array_equal(x[:n], cubic.cubic_roots_qbc(*A)), "failed for polynom %s" % str(A)
+        # Batch
+        address, signature = cubic.c_api["cubic_roots_batch_f"]
+        batch = ctypes.CFUNCTYPE(None, ctypes.c_void_p, ctypes.c_int64, ctypes.c_void_p, ctypes.c_void_p)(address)
+        A = polys.astype(np.float32)
+        roots = np.full((len(A), 3), np.nan, np.float32)
+        nroots = np.empty(len(A), np.intc)
+        batch(A.ctypes.data, len(A), roots.ctypes.data, nroots.ctypes.data)
+        expected, nexpected = cubic.cubic_roots_batch(A)
+        assert np.array_equal(nroots, nexpected) and np.array_equal(roots, expected, equal_nan=True)
+
     def test_cmp_algos_max_1e5(self):
         N = int(1e6)
         N_runs = 3
@@ -0,0 +1,103 @@
+import unittest
+import sys
+import os
+import socket
+import subprocess
+import tempfile
+import threading
+import time
+client_path = os.path.join(os.path.dirname(os.path.realpath(__file__)), "../cubic_daemon/python")
+sys.path.insert(0, client_path)
+import cubic_client
+import numpy as np
+from multiprocessing import shared_memory
+
+# Daemon executable, override by $CUBIC_DAEMON.
+DAEMON = os.environ.get("CUBIC_DAEMON", os.path.join(os.path.dirname(os.path.realpath(__file__)),
+                                                     "../out/build/x64-Release/cubic_daemon/cubic_DAEMON"))
+
+def request(path, N, shm_name, dtype=np.float64):
+    """
+    Send a raw job request and return the reply status.
+    """
+    with socket.socket(socket.AF_UNIX, socket.SOCK_STREAM) as sock:
+        sock.connect(path)
+        sock.sendall(cubic_client._REQUEST.pack(cubic_client.MAGIC, cubic_client.DTYPES[np.dtype(dtype)], N,
+                                                shm_name.encode()))
+        data = b""
+        while len(data) < cubic_client._REPLY.size:
+            chunk = sock.recv(cubic_client._REPLY.size - len(data))
+            if not chunk:
+                raise ConnectionError("Connection to cubic daemon lost.")
+            data += chunk
+        return cubic_client._REPLY.unpack(data)[0]
+
+
+@unittest.skipUnless(os.path.isfile(DAEMON), "cubic daemon not built")
+class Unittest(unittest.TestCase):
+
+    @classmethod
+    def setUpClass(cls):
+        cls.tmpdir = tempfile.TemporaryDirectory()
+        cls.path = os.path.join(cls.tmpdir.name, "cubic.sock")
+        cls.daemon = subprocess.Popen([DAEMON, cls.path], stdout=subprocess.DEVNULL)
+        for _ in range(100):
+            if os.path.exists(cls.path):
+                break
+            time.sleep(0.05)
+
+    @classmethod
+    def tearDownClass(cls):
+        cls.daemon.kill()
+        cls.daemon.wait()
+        cls.tmpdir.cleanup()
+
+    def test_round_trip(self):
+        """ Roots solved by the daemon match the input equations (x - 1)(x - 2)(x - 3) and x^3 + 1. """
+        for dtype in [np.float64, np.float32]:
+            with cubic_client.CubicClient(self.path) as client, cubic_client.SharedBatch(2, dtype) as batch:
+                batch.coeffs[:] = [[1, -6, 11, -6], [1, 0, 0, 1]]
+                self.assertEqual(client.solve(batch), 4)
+                np.testing.assert_array_equal(batch.nroots, [3, 1])
+                np.testing.assert_allclose(np.sort(batch.roots(0)), [1, 2, 3], rtol=1e-5)
+                np.testing.assert_allclose(batch.roots(1), [-1], rtol=1e-5)
+
+    def test_oversized_N(self):
+        """ N overflowing the segment size is rejected, not wrapped around. """
+        with cubic_client.SharedBatch(1) as batch:
+            for N in [2**63 - 1, 2**61 + 1, -1]:
+                self.assertEqual(request(self.path, N, batch.name), 1)
+
+    def test_short_segment(self):
+        """ A segment smaller than N equations is rejected. """
+        with cubic_client.SharedBatch(4) as batch:
+            self.assertEqual(request(self.path, 4, batch.name), 0)
+            self.assertEqual(request(self.path, 5, batch.name), 2)
+            self.assertEqual(request(self.path, 4, batch.name, np.float32), 0)
+            self.assertEqual(request(self.path, 1, "/cubic_missing_segment"), 2)
+
+    def test_truncated_during_job(self):
+        """ A segment truncated by the client while the daemon reads it fails the job, not the daemon. """
+        for delay in [0.0, 0.001, 0.005]:
+            with cubic_client.SharedBatch(2000000) as batch:
+                batch.coeffs[:] = 1.0
+                fd = os.open("/dev/shm" + batch.name, os.O_RDWR)
+                truncate = threading.Timer(delay, os.ftruncate, (fd, 4096))
+                truncate.start()
+                status = request(self.path, batch.N, batch.name)
+                truncate.join()
+                os.close(fd)
+                self.assertIn(status, [0, 2])
+                self.assertIsNone(self.daemon.poll())
+
+    def test_refuses_non_socket(self):
+        """ The daemon does not remove an existing file that is not a socket. """
+        with tempfile.NamedTemporaryFile(dir=self.tmpdir.name) as f:
+            result = subprocess.run([DAEMON, f.name], stdout=subprocess.DEVNULL, stderr=subprocess.DEVNULL,
+                                    timeout=10)
+            self.assertNotEqual(result.returncode, 0)
+            self.assertTrue(os.path.isfile(f.name))
+
+
+if __name__ == '__main__':
+    unittest.main()